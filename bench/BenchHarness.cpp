@@ -0,0 +1,120 @@
+#include "BenchHarness.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+namespace {
+
+double Percentile(std::vector<double>& sorted, double fraction) {
+    size_t index = (size_t)(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Benchmark names are plain identifiers plus a few punctuation characters,
+// but escape the JSON specials anyway
+std::string JsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Reads back the name/median pairs of a file written by WriteJson. Not a
+// general JSON parser: it relies on every object holding "name" before
+// "median_ns", which WriteJson guarantees.
+bool ReadBaselineMedians(const std::string& path, std::map<std::string, double>& medians) {
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string text = buffer.str();
+
+    const std::string nameKey = "\"name\": \"";
+    const std::string medianKey = "\"median_ns\": ";
+    size_t position = 0;
+    while ((position = text.find(nameKey, position)) != std::string::npos) {
+        size_t nameStart = position + nameKey.size();
+        size_t nameEnd = nameStart;
+        std::string name;
+        while (nameEnd < text.size() && text[nameEnd] != '"') {
+            if (text[nameEnd] == '\\' && nameEnd + 1 < text.size()) nameEnd++;
+            name += text[nameEnd++];
+        }
+        size_t medianPosition = text.find(medianKey, nameEnd);
+        if (medianPosition == std::string::npos) return false;
+        medians[name] = std::strtod(text.c_str() + medianPosition + medianKey.size(), nullptr);
+        position = medianPosition;
+    }
+    return true;
+}
+
+} // namespace
+
+void BenchHarness::Record(const std::string& name, uint64_t batch, std::vector<double>& nsPerCall,
+                          std::vector<double>& cyclesPerCall) {
+    std::sort(nsPerCall.begin(), nsPerCall.end());
+    std::sort(cyclesPerCall.begin(), cyclesPerCall.end());
+
+    Result result;
+    result.name = name;
+    result.callsPerRep = batch;
+    result.reps = (int)nsPerCall.size();
+    result.medianNs = Percentile(nsPerCall, 0.5);
+    result.p99Ns = Percentile(nsPerCall, 0.99);
+#ifdef BATTLESHIP_BENCH_HAS_TSC
+    result.cyclesPerCall = Percentile(cyclesPerCall, 0.5);
+#endif
+    results.push_back(result);
+
+    std::cout << std::left << std::setw(44) << name << std::right << std::fixed << std::setprecision(1)
+              << std::setw(12) << result.medianNs << " ns  p99 " << std::setw(12) << result.p99Ns << " ns";
+    if (result.cyclesPerCall >= 0.0) {
+        std::cout << std::setw(12) << result.cyclesPerCall << " cycles";
+    }
+    std::cout << std::defaultfloat << std::endl;
+}
+
+bool BenchHarness::WriteJson(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) return false;
+    file << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        file << "    {\"name\": \"" << JsonEscape(result.name) << "\", \"calls_per_rep\": " << result.callsPerRep
+             << ", \"reps\": " << result.reps << ", \"median_ns\": " << result.medianNs
+             << ", \"p99_ns\": " << result.p99Ns << ", \"cycles_per_call\": ";
+        if (result.cyclesPerCall >= 0.0) {
+            file << result.cyclesPerCall;
+        } else {
+            file << "null";
+        }
+        file << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    file << "  ]\n}\n";
+    return (bool)file;
+}
+
+int BenchHarness::CompareWithBaseline(const std::string& path, double tolerance, bool& loaded) const {
+    std::map<std::string, double> baseline;
+    loaded = ReadBaselineMedians(path, baseline);
+    if (!loaded) return 0;
+
+    int regressions = 0;
+    for (const Result& result : results) {
+        auto found = baseline.find(result.name);
+        if (found == baseline.end() || found->second <= 0.0) continue;
+        double ratio = result.medianNs / found->second;
+        bool regressed = ratio > 1.0 + tolerance;
+        regressions += regressed ? 1 : 0;
+        std::cout << (regressed ? "REGRESSION " : (ratio < 1.0 - tolerance ? "improved   " : "ok         "))
+                  << std::left << std::setw(44) << result.name << std::right << std::fixed << std::setprecision(2)
+                  << ratio << "x baseline" << std::defaultfloat << std::endl;
+    }
+    return regressions;
+}
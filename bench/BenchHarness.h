@@ -0,0 +1,108 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define BATTLESHIP_BENCH_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// Minimal timing harness: calibrates a batch so one repetition takes long
+// enough for the clock, warms up, then times a fixed number of repetitions
+// and reports the median and p99 time per call. Cycle counts come from the
+// time-stamp counter where there is one (reference cycles, not core cycles,
+// so they drift with turbo).
+class BenchHarness {
+public:
+    struct Result {
+        std::string name;
+        uint64_t callsPerRep = 0;
+        int reps = 0;
+        double medianNs = 0.0;
+        double p99Ns = 0.0;
+        double cyclesPerCall = -1.0; // Negative when no cycle counter is available
+    };
+
+    struct Settings {
+        int warmupReps = 20;
+        int reps = 200;
+        bool repsFixed = false; // reps came from the command line; cases can't lower it
+        std::chrono::nanoseconds minRepTime{std::chrono::microseconds(200)};
+    };
+
+    explicit BenchHarness(std::string filter = "") : filter(std::move(filter)) {}
+
+    // Times body(), which performs one call and returns something derived from
+    // its result so the compiler can't drop it. Slow cases pass fewer reps,
+    // which cap the default but never an explicit --reps.
+    template <typename Body>
+    void Run(const std::string& name, Body&& body, int reps = 0) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        Settings current = settings;
+        if (reps > 0 && !current.repsFixed) current.reps = std::min(current.reps, reps);
+
+        uint64_t batch = 1;
+        while (TimeBatch(body, batch).first < current.minRepTime && batch < (1ull << 30)) {
+            batch *= 2;
+        }
+        for (int i = 0; i < current.warmupReps; ++i) {
+            TimeBatch(body, batch);
+        }
+
+        std::vector<double> nsPerCall(current.reps);
+        std::vector<double> cyclesPerCall(current.reps);
+        for (int i = 0; i < current.reps; ++i) {
+            auto [elapsed, cycles] = TimeBatch(body, batch);
+            nsPerCall[i] = std::chrono::duration<double, std::nano>(elapsed).count() / batch;
+            cyclesPerCall[i] = (double)cycles / batch;
+        }
+        Record(name, batch, nsPerCall, cyclesPerCall);
+    }
+
+    const std::vector<Result>& GetResults() const { return results; }
+    Settings& GetSettings() { return settings; }
+
+    bool WriteJson(const std::string& path) const;
+
+    // Compares medians against a file written by WriteJson. Prints one line per
+    // benchmark found in both and returns how many got slower than tolerance.
+    int CompareWithBaseline(const std::string& path, double tolerance, bool& loaded) const;
+
+private:
+    Settings settings;
+    std::string filter;
+    std::vector<Result> results;
+    volatile uint64_t sink = 0; // Keeps every body's result observable
+
+    static uint64_t ReadCycleCounter() {
+#ifdef BATTLESHIP_BENCH_HAS_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    template <typename Body>
+    std::pair<std::chrono::nanoseconds, uint64_t> TimeBatch(Body& body, uint64_t batch) {
+        uint64_t local = 0;
+        auto start = std::chrono::steady_clock::now();
+        uint64_t startCycles = ReadCycleCounter();
+        for (uint64_t i = 0; i < batch; ++i) {
+            local += (uint64_t)body();
+        }
+        uint64_t cycles = ReadCycleCounter() - startCycles;
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        sink = sink + local;
+        return {std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed), cycles};
+    }
+
+    void Record(const std::string& name, uint64_t batch, std::vector<double>& nsPerCall,
+                std::vector<double>& cyclesPerCall);
+};
@@ -0,0 +1,93 @@
+#include "Benchmarks.h"
+#include "Ship.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+// Micro-benchmarks for the grid, placement, sinking and targeting hot paths.
+// Usage: battleship_bench [--filter TEXT] [--reps N] [--json PATH]
+//                         [--baseline PATH [--tolerance FRACTION]]
+// --baseline compares medians against an earlier --json file and exits with
+// status 1 if any benchmark got slower than the tolerance (default 10%).
+
+namespace {
+
+// Half-filled boards, built the same way the AI used to place its fleet
+std::vector<Grid> BuildBoards() {
+    std::mt19937 rng(12345);
+    ShipManager shipManager;
+    std::vector<Grid> boards(64);
+    for (Grid& board : boards) {
+        std::uniform_int_distribution<> posDist(0, GRID_SIZE - 1);
+        for (int i = 0; i < 5; ++i) {
+            for (int attempt = 0; attempt < 1000; ++attempt) {
+                int x = posDist(rng);
+                int y = posDist(rng);
+                bool horizontal = (rng() & 1) == 0;
+                if (shipManager.IsValidPlacement(board, x, y, shipManager.GetShips()[i].size, horizontal)) {
+                    shipManager.PlaceShip(board, x, y, shipManager.GetShips()[i].size, horizontal);
+                    break;
+                }
+            }
+        }
+    }
+    return boards;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    std::string jsonPath;
+    std::string baselinePath;
+    double tolerance = 0.10;
+    int reps = 0;
+    for (int i = 1; i < argc; ++i) {
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) {
+            std::cerr << "Missing value for " << argv[i] << std::endl;
+            return 2;
+        }
+        if (std::strcmp(argv[i], "--filter") == 0) filter = value;
+        else if (std::strcmp(argv[i], "--json") == 0) jsonPath = value;
+        else if (std::strcmp(argv[i], "--baseline") == 0) baselinePath = value;
+        else if (std::strcmp(argv[i], "--tolerance") == 0) tolerance = std::atof(value);
+        else if (std::strcmp(argv[i], "--reps") == 0) reps = std::atoi(value);
+        else {
+            std::cerr << "Usage: battleship_bench [--filter TEXT] [--reps N] [--json PATH] "
+                         "[--baseline PATH [--tolerance FRACTION]]" << std::endl;
+            return 2;
+        }
+        i++;
+    }
+
+    BenchHarness harness(filter);
+    if (reps > 0) {
+        harness.GetSettings().reps = reps;
+        harness.GetSettings().repsFixed = true;
+    }
+    std::vector<Grid> boards = BuildBoards();
+    if (!RunPlacementBenchmarks(harness, boards) || !RunGameBenchmarks(harness, boards)) {
+        return 1;
+    }
+
+    if (!jsonPath.empty() && !harness.WriteJson(jsonPath)) {
+        std::cerr << "Could not write " << jsonPath << std::endl;
+        return 1;
+    }
+    if (!baselinePath.empty()) {
+        bool loaded = false;
+        int regressions = harness.CompareWithBaseline(baselinePath, tolerance, loaded);
+        if (!loaded) {
+            std::cerr << "Could not read baseline " << baselinePath << std::endl;
+            return 1;
+        }
+        if (regressions > 0) {
+            std::cout << regressions << " benchmark(s) regressed by more than " << tolerance * 100.0 << "%" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
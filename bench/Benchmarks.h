@@ -0,0 +1,9 @@
+#pragma once
+#include <vector>
+#include "BenchHarness.h"
+#include "Grid.h"
+
+// Each group times its own hot paths on the shared half-filled boards.
+// A group returns false if a sanity check failed before timing.
+bool RunPlacementBenchmarks(BenchHarness& harness, const std::vector<Grid>& boards);
+bool RunGameBenchmarks(BenchHarness& harness, const std::vector<Grid>& boards);
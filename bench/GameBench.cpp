@@ -0,0 +1,152 @@
+#include "AIPlayer.h"
+#include "BatchedEnv.h"
+#include "Benchmarks.h"
+#include "FleetGenerator.h"
+#include "GameModel.h"
+#include "Ship.h"
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+// An AI partway through a game against a uniformly drawn fleet, so its
+// sunk-ship bookkeeping matches what the grid shows
+struct TargetingPosition {
+    Grid grid;
+    std::unique_ptr<AIPlayer> player;
+};
+
+std::vector<TargetingPosition> BuildPositions(TargetingStrategy strategy, int shots, int count, uint64_t seed) {
+    std::vector<TargetingPosition> positions(count);
+    for (int i = 0; i < count; ++i) {
+        TargetingPosition& position = positions[i];
+        AIPlayer placer(seed + 1000 + i);
+        placer.SetVerbose(false);
+        placer.PlaceShips(position.grid);
+
+        position.player = std::make_unique<AIPlayer>(seed + i);
+        AIPlayer& player = *position.player;
+        player.SetVerbose(false);
+        player.SetTargetingStrategy(strategy);
+        for (int shot = 0; shot < shots && position.grid.CountRemainingShips() > 0; ++shot) {
+            GridPosition target = player.GetTarget(position.grid);
+            ShotResult result = position.grid.ReceiveShot(target.x, target.y);
+            if (result == ShotResult::Hit || result == ShotResult::Sunk) {
+                player.SetLastHit(target);
+            }
+            if (result == ShotResult::Sunk) {
+                player.NotifyShipSunk(position.grid.GetShipCells(position.grid.GetShipId(target.x, target.y)));
+            }
+        }
+    }
+    return positions;
+}
+
+} // namespace
+
+bool RunGameBenchmarks(BenchHarness& harness, const std::vector<Grid>& boards) {
+    ShipManager shipManager;
+
+    // Boards with about half of their ship cells hit, probed at every hit
+    std::vector<Grid> shotBoards = boards;
+    std::vector<std::pair<const Grid*, GridPosition>> hits;
+    std::mt19937 rng(4242);
+    for (Grid& board : shotBoards) {
+        for (BitBoard cells = board.GetShipMask(); cells.Any();) {
+            int index = cells.PopLowest();
+            if (rng() & 1) {
+                GridPosition hit(index % GRID_SIZE, index / GRID_SIZE);
+                board.ReceiveShot(hit.x, hit.y);
+                hits.push_back({&board, hit});
+            }
+        }
+    }
+    if (hits.empty()) return false;
+
+    size_t next = 0;
+    harness.Run("ShipManager::IsShipSunk", [&] {
+        const auto& [board, hit] = hits[next];
+        next = next + 1 == hits.size() ? 0 : next + 1;
+        return shipManager.IsShipSunk(*board, hit);
+    });
+
+    next = 0;
+    harness.Run("Grid::CountRemainingShips", [&] {
+        const Grid& board = shotBoards[next];
+        next = next + 1 == shotBoards.size() ? 0 : next + 1;
+        return board.CountRemainingShips();
+    });
+
+    // Cloning a mid-battle position, as a search would before trying a move
+    std::vector<GameModel> models(shotBoards.size());
+    for (size_t i = 0; i < models.size(); ++i) {
+        models[i].match.GetGrid(Side::AI) = shotBoards[i];
+    }
+    GameModel clone;
+    next = 0;
+    harness.Run("GameModel copy", [&] {
+        clone = models[next];
+        next = next + 1 == models.size() ? 0 : next + 1;
+        return clone.match.GetGrid(Side::AI).GetShipCount();
+    });
+
+    // Uniform layout sampling; milliseconds per call, so fewer repetitions
+    AIPlayer placer(99);
+    placer.SetVerbose(false);
+    Grid placementGrid;
+    harness.Run("AIPlayer::PlaceShips", [&] {
+        placementGrid.Reset();
+        placer.PlaceShips(placementGrid);
+        return placementGrid.GetShipCount();
+    }, 30);
+
+    // Random's queue drains on repeated calls, so it is timed while hunting.
+    // Hard is left out: it samples until its time budget runs out.
+    struct TargetingCase {
+        const char* name;
+        TargetingStrategy strategy;
+        int shots;
+        int reps;
+    };
+    const TargetingCase cases[] = {
+        {"AIPlayer::GetTarget/Random@10", TargetingStrategy::RandomAdjacent, 10, 0},
+        {"AIPlayer::GetTarget/Density@20", TargetingStrategy::ProbabilityDensity, 20, 0},
+        {"AIPlayer::GetTarget/Density@45", TargetingStrategy::ProbabilityDensity, 45, 50},
+    };
+    for (const TargetingCase& targetingCase : cases) {
+        std::vector<TargetingPosition> positions = BuildPositions(targetingCase.strategy, targetingCase.shots, 8, 31337);
+        next = 0;
+        harness.Run(targetingCase.name, [&] {
+            TargetingPosition& position = positions[next];
+            next = next + 1 == positions.size() ? 0 : next + 1;
+            GridPosition target = position.player->GetTarget(position.grid);
+            return target.x * GRID_SIZE + target.y;
+        }, targetingCase.reps);
+    }
+
+    // One call steps every game once; each game fires down its own shuffled
+    // cell list so no shot is wasted. Single-threaded: the per-game cost.
+    constexpr int ENV_COUNT = 1024;
+    BatchedEnv env(ENV_COUNT, 7, 1);
+    std::vector<std::array<int32_t, BatchedEnv::CELL_COUNT>> cellOrders(ENV_COUNT);
+    std::vector<int> cursors(ENV_COUNT, 0);
+    std::vector<int32_t> actions(ENV_COUNT);
+    for (auto& order : cellOrders) {
+        for (int cell = 0; cell < BatchedEnv::CELL_COUNT; ++cell) order[cell] = cell;
+        std::shuffle(order.begin(), order.end(), rng);
+    }
+    harness.Run("BatchedEnv::Step/1024", [&] {
+        for (int i = 0; i < ENV_COUNT; ++i) {
+            actions[i] = cellOrders[i][cursors[i]];
+        }
+        env.Step(actions);
+        const StepStatus* statuses = env.GetStatuses();
+        for (int i = 0; i < ENV_COUNT; ++i) {
+            cursors[i] = statuses[i] == StepStatus::Running ? cursors[i] + 1 : 0;
+        }
+        return (uint64_t)env.GetRewards()[0];
+    }, 50);
+    return true;
+}
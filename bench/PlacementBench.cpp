@@ -0,0 +1,101 @@
+#include "Benchmarks.h"
+#include "Grid.h"
+#include "Ship.h"
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Per-cell validation as IsValidPlacement did it before the placement tables:
+// bounds check, then each ship cell and its 3x3 neighbourhood via GetCell.
+static bool IsValidPlacementPerCell(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) {
+    if (horizontal) {
+        if (startX + shipSize > GRID_SIZE || startY >= GRID_SIZE) {
+            return false;
+        }
+    } else {
+        if (startX >= GRID_SIZE || startY + shipSize > GRID_SIZE) {
+            return false;
+        }
+    }
+    
+    for (int i = 0; i < shipSize; ++i) {
+        int checkX = horizontal ? startX + i : startX;
+        int checkY = horizontal ? startY : startY + i;
+        
+        CellState currentCell = grid.GetCell(checkX, checkY);
+        if (currentCell != CellState::Empty && 
+            currentCell != CellState::Preview && 
+            currentCell != CellState::InvalidPreview) {
+            return false;
+        }
+        
+        for (int dx = -1; dx <= 1; ++dx) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                if (dx == 0 && dy == 0) continue;
+                if (grid.IsValidPosition(checkX + dx, checkY + dy) &&
+                    grid.GetCell(checkX + dx, checkY + dy) == CellState::Ship) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+namespace {
+
+struct PlacementQuery {
+    const Grid* board;
+    int8_t x;
+    int8_t y;
+    int8_t size;
+    bool horizontal;
+};
+
+} // namespace
+
+bool RunPlacementBenchmarks(BenchHarness& harness, const std::vector<Grid>& boards) {
+    // Every anchor, size and orientation on every board, in a fixed shuffled
+    // order so the branch predictor can't learn the sequence
+    std::vector<PlacementQuery> queries;
+    for (const Grid& board : boards) {
+        for (int size = 2; size <= 5; ++size) {
+            for (int orientation = 0; orientation < 2; ++orientation) {
+                for (int y = 0; y < GRID_SIZE; ++y) {
+                    for (int x = 0; x < GRID_SIZE; ++x) {
+                        queries.push_back({&board, (int8_t)x, (int8_t)y, (int8_t)size, orientation == 0});
+                    }
+                }
+            }
+        }
+    }
+    std::mt19937 rng(777);
+    std::shuffle(queries.begin(), queries.end(), rng);
+
+    // The table must agree with the per-cell reference before timing means anything
+    int tableValid = 0;
+    int loopValid = 0;
+    for (const PlacementQuery& query : queries) {
+        tableValid += ShipManager::IsValidPlacement(*query.board, query.x, query.y, query.size, query.horizontal);
+        loopValid += IsValidPlacementPerCell(*query.board, query.x, query.y, query.size, query.horizontal);
+    }
+    if (tableValid != loopValid) {
+        std::cerr << "Mismatch: table accepted " << tableValid << " placements, per-cell loop " << loopValid << std::endl;
+        return false;
+    }
+
+    size_t next = 0;
+    harness.Run("ShipManager::IsValidPlacement", [&] {
+        const PlacementQuery& query = queries[next];
+        next = next + 1 == queries.size() ? 0 : next + 1;
+        return ShipManager::IsValidPlacement(*query.board, query.x, query.y, query.size, query.horizontal);
+    });
+    next = 0;
+    harness.Run("IsValidPlacement/per-cell-reference", [&] {
+        const PlacementQuery& query = queries[next];
+        next = next + 1 == queries.size() ? 0 : next + 1;
+        return IsValidPlacementPerCell(*query.board, query.x, query.y, query.size, query.horizontal);
+    });
+    return true;
+}
@@ -1,74 +1,172 @@
 #include "AIPlayer.h"
 #include "Grid.h"
-#include <iostream>
+#include "Log.h"
+#include <algorithm>
+#include <array>
 
-AIPlayer::AIPlayer() : lastHit(-1, -1) {
-    std::random_device rd;
-    randomGenerator.seed(rd());
+const char* GetTargetingStrategyName(TargetingStrategy strategy) {
+    switch (strategy) {
+        case TargetingStrategy::RandomAdjacent: return "Random";
+        case TargetingStrategy::ProbabilityDensity: return "Density";
+        case TargetingStrategy::MonteCarlo: return "Hard";
+    }
+    return "Unknown";
+}
+
+AIPlayer::AIPlayer() : AIPlayer(std::random_device()()) {
+}
+
+AIPlayer::AIPlayer(uint64_t seed) : lastHit(-1, -1), targetingStrategy(TargetingStrategy::ProbabilityDensity),
+    monteCarloBudget(5000), monteCarloThreads(0), endgameEnabled(true), verbose(true), shipsPrepared(false) {
+    SetSeed(seed);
     InitializeAI();
 }
 
+void AIPlayer::SetSeed(uint64_t seed) {
+    std::seed_seq sequence{(uint32_t)seed, (uint32_t)(seed >> 32)};
+    randomGenerator.seed(sequence);
+    shipsPrepared = false; // Drawn from the old seed
+}
+
 void AIPlayer::Reset() {
     lastHit = GridPosition(-1, -1);
     targetQueue.clear();
     shipManager.Reset();
+    shipsPrepared = false;
+    ResetOpponentFleet();
+    endgameSolver.ClearTable();
+}
+
+void AIPlayer::ResetOpponentFleet() {
+    sunkCells = BitBoard();
+    opponentShipsAfloat.fill(0);
+    for (const Ship& ship : shipManager.GetShips()) {
+        if (ship.size >= 1 && ship.size <= MAX_SHIP_SIZE) {
+            opponentShipsAfloat[ship.size]++;
+        }
+    }
 }
 
 void AIPlayer::InitializeAI() {
-    shipManager.GetShips().clear();
-    // 1x Battleship (Size 5)
-    shipManager.GetShips().emplace_back(ShipType::Battleship, 5, "AI Battleship");
-    
-    // 2x Cruiser (Size 4)
-    shipManager.GetShips().emplace_back(ShipType::Cruiser, 4, "AI Cruiser 1");
-    shipManager.GetShips().emplace_back(ShipType::Cruiser, 4, "AI Cruiser 2");
-    
-    // 3x Destroyer (Size 3)
-    shipManager.GetShips().emplace_back(ShipType::Destroyer, 3, "AI Destroyer 1");
-    shipManager.GetShips().emplace_back(ShipType::Destroyer, 3, "AI Destroyer 2");
-    shipManager.GetShips().emplace_back(ShipType::Destroyer, 3, "AI Destroyer 3");
-    
-    // 4x Submarine (Size 2)
-    shipManager.GetShips().emplace_back(ShipType::Submarine, 2, "AI Submarine 1");
-    shipManager.GetShips().emplace_back(ShipType::Submarine, 2, "AI Submarine 2");
-    shipManager.GetShips().emplace_back(ShipType::Submarine, 2, "AI Submarine 3");
-    shipManager.GetShips().emplace_back(ShipType::Submarine, 2, "AI Submarine 4");
+    // Same make-up as the player's fleet
+    shipManager.InitializeShips();
     
     targetQueue.clear();
     lastHit = GridPosition(-1, -1);
+    ResetOpponentFleet();
+}
+
+void AIPlayer::PrepareShips() {
+    // Draw uniformly from all legal layouts so opponents can't exploit a placement bias
+    std::span<Ship> ships = shipManager.GetShips();
+    std::array<int, MAX_FLEET_SIZE> sizes;
+    int count = std::min((int)ships.size(), MAX_FLEET_SIZE);
+    for (int i = 0; i < count; ++i) {
+        sizes[i] = ships[i].size;
+    }
+    
+    shipsPrepared = fleetSampler.Sample(std::span<const int>(sizes.data(), count), randomGenerator,
+                                        std::span<ShipPlacement>(preparedShips.data(), count));
 }
 
 void AIPlayer::PlaceShips(Grid& aiGrid) {
-    std::cout << "AI is placing ships..." << std::endl;
+    if (verbose) {
+        LOG_INFO(LogCategory::AI, "AI is placing ships...");
+    }
     
-    std::uniform_int_distribution<> posDist(0, GRID_SIZE - 1);
-    std::uniform_int_distribution<> orientDist(0, 1);
+    if (!shipsPrepared) {
+        PrepareShips();
+    }
+    if (!shipsPrepared) {
+        LOG_ERROR(LogCategory::AI, "AI could not find a legal fleet layout!");
+        return;
+    }
     
-    for (auto& ship : shipManager.GetShips()) {
-        bool placed = false;
-        int attempts = 0;
-        
-        while (!placed && attempts < 1000) {
-            int x = posDist(randomGenerator);
-            int y = posDist(randomGenerator);
-            bool horizontal = orientDist(randomGenerator) == 0;
-            
-            if (IsValidShipPlacement(aiGrid, x, y, ship.size, horizontal)) {
-                PlaceShip(aiGrid, x, y, ship.size, horizontal);
-                ship.placed = true;
-                placed = true;
-                //std::cout << "AI placed " << ship.name << " at " << (char)('A' + x) << (y + 1) 
-                //         << " (" << (horizontal ? "horizontal" : "vertical") << ")" << std::endl;
-            }
-            attempts++;
-        }
+    std::span<Ship> ships = shipManager.GetShips();
+    int count = std::min((int)ships.size(), MAX_FLEET_SIZE);
+    for (int i = 0; i < count; ++i) {
+        const ShipPlacement& placement = preparedShips[i];
+        shipManager.PlaceShip(aiGrid, placement.x, placement.y, placement.size, placement.horizontal);
+        ships[i].placed = true;
     }
+    shipsPrepared = false;
 }
 
 
-// TODO: Implement a more sophisticated AI targeting strategy
-// For now, this will use a simple random targeting strategy with some basic logic for hits
-GridPosition AIPlayer::GetTarget(const Grid& playerGrid) {
+void AIPlayer::SetMonteCarloTimeBudget(std::chrono::microseconds budget) {
+    monteCarloBudget = budget;
+    if (monteCarlo) {
+        monteCarlo->SetTimeBudget(budget);
+    }
+}
+
+GridPosition AIPlayer::GetTarget(const Grid& playerGrid, SearchObserver* observer) {
+    GridPosition endgameTarget;
+    if (targetingStrategy != TargetingStrategy::RandomAdjacent && endgameEnabled &&
+        GetEndgameTarget(playerGrid, endgameTarget, observer)) {
+        return endgameTarget;
+    }
+    
+    switch (targetingStrategy) {
+        case TargetingStrategy::ProbabilityDensity: return GetDensityTarget(playerGrid);
+        case TargetingStrategy::MonteCarlo: return GetMonteCarloTarget(playerGrid, observer);
+        case TargetingStrategy::RandomAdjacent: break;
+    }
+    return GetRandomAdjacentTarget(playerGrid);
+}
+
+// Only what a shooter can see: shot results and the ships reported sunk
+TargetingView AIPlayer::BuildTargetingView(const Grid& playerGrid) const {
+    TargetingView view;
+    view.openHits = playerGrid.GetHitMask() & ~sunkCells;
+    view.misses = playerGrid.GetMissMask();
+    view.sunkCells = sunkCells;
+    view.remainingShips = opponentShipsAfloat;
+    return view;
+}
+
+// Succeeds once few enough layouts are left for an exact search
+bool AIPlayer::GetEndgameTarget(const Grid& playerGrid, GridPosition& target, SearchObserver* observer) {
+    int cell = -1;
+    bool solved = endgameSolver.FindBestShot(BuildTargetingView(playerGrid), cell, observer);
+    const EndgameSolver::Stats& stats = endgameSolver.GetLastStats();
+    if (!solved) {
+        return false;
+    }
+    if (verbose) {
+        double nodesPerSecond = stats.seconds > 0.0 ? stats.nodes / stats.seconds : 0.0;
+        double hitRate = stats.tableProbes > 0 ? 100.0 * stats.tableHits / stats.tableProbes : 0.0;
+        LOG_INFO(LogCategory::AI, "Endgame: {} layouts, {} shots expected, {} nodes ({} nodes/s), table hit rate {}%",
+                 stats.layouts, stats.expectedShots, stats.nodes, (long long)nodesPerSecond, hitRate);
+    }
+    
+    target = GridPosition(cell % GRID_SIZE, cell / GRID_SIZE);
+    return true;
+}
+
+GridPosition AIPlayer::GetDensityTarget(const Grid& playerGrid) {
+    int cell = ChooseDensityTarget(BuildTargetingView(playerGrid), randomGenerator);
+    if (cell < 0) {
+        return GridPosition(0, 0); // Every cell shot; the game is over by now
+    }
+    return GridPosition(cell % GRID_SIZE, cell / GRID_SIZE);
+}
+
+GridPosition AIPlayer::GetMonteCarloTarget(const Grid& playerGrid, SearchObserver* observer) {
+    if (!monteCarlo) {
+        monteCarlo = std::make_unique<MonteCarloTargeting>(monteCarloThreads);
+        monteCarlo->SetTimeBudget(monteCarloBudget);
+    }
+    
+    int cell = monteCarlo->ChooseTarget(BuildTargetingView(playerGrid), randomGenerator, observer);
+    if (cell < 0) {
+        return GridPosition(0, 0); // Every cell shot; the game is over by now
+    }
+    return GridPosition(cell % GRID_SIZE, cell / GRID_SIZE);
+}
+
+// Random hunting with a queue of probes around hits
+GridPosition AIPlayer::GetRandomAdjacentTarget(const Grid& playerGrid) {
     // If we have targets in the queue (from previous hits), use them first
     while (!targetQueue.empty()) {
         GridPosition target = targetQueue.back();
@@ -111,34 +209,33 @@ GridPosition AIPlayer::GetTarget(const Grid& playerGrid) {
         }
     }
     
-    // Random targeting
-    std::uniform_int_distribution<> dist(0, GRID_SIZE - 1);
-    GridPosition target;
-    int attempts = 0;
+    // Random targeting among the cells not shot yet
+    BitBoard unshot = BOARD_MASK & ~(playerGrid.GetHitMask() | playerGrid.GetMissMask());
+    if (unshot.None()) {
+        return GridPosition(0, 0); // Should not happen, the game ends first
+    }
+    int pick = std::uniform_int_distribution<int>(0, unshot.Count() - 1)(randomGenerator);
+    int cell = unshot.NthIndex(pick);
+    return GridPosition(cell % GRID_SIZE, cell / GRID_SIZE);
+}
+
+void AIPlayer::NotifyShipSunk(const BitBoard& shipCells) {
+    sunkCells |= shipCells;
+    int size = shipCells.Count();
+    if (size <= MAX_SHIP_SIZE && opponentShipsAfloat[size] > 0) {
+        opponentShipsAfloat[size]--;
+    }
     
-    do {
-        target.x = dist(randomGenerator);
-        target.y = dist(randomGenerator);
-        attempts++;
-        
-        // Safety check to prevent infinite loop
-        if (attempts > 1000) {
-            // Find any untargeted cell
-            for (int y = 0; y < GRID_SIZE; ++y) {
-                for (int x = 0; x < GRID_SIZE; ++x) {
-                    CellState cell = playerGrid.GetCell(x, y);
-                    if (cell != CellState::Hit && cell != CellState::Miss) {
-                        return GridPosition(x, y);
-                    }
-                }
-            }
-            // If no valid targets found, return default (should not happen)
-            return GridPosition(0, 0);
-        }
-    } while (playerGrid.GetCell(target.x, target.y) == CellState::Hit || 
-             playerGrid.GetCell(target.x, target.y) == CellState::Miss);
+    // Forget the hit that belonged to the sunk ship
+    if (lastHit.x >= 0 && lastHit.y >= 0 && shipCells.Test(lastHit.x, lastHit.y)) {
+        lastHit = GridPosition(-1, -1);
+    }
     
-    return target;
+    // Drop queued probes around the sunk ship; probes for other damaged ships stay
+    BitBoard surroundings = shipCells.Dilate();
+    std::erase_if(targetQueue, [&surroundings](const GridPosition& target) {
+        return surroundings.Test(target.x, target.y);
+    });
 }
 
 bool AIPlayer::IsValidShipPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) const {
@@ -1,24 +1,75 @@
 #pragma once
+#include <chrono>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <random>
 #include "GameState.h"
 #include "Ship.h"
+#include "FleetGenerator.h"
+#include "DensityTargeting.h"
+#include "MonteCarloTargeting.h"
+#include "EndgameSolver.h"
 
 class Grid;
 
+enum class TargetingStrategy {
+    RandomAdjacent,     // Random hunting, then probe around the last hit
+    ProbabilityDensity, // Fire where the most consistent ship placements overlap
+    MonteCarlo,         // Sample whole consistent layouts within a time budget
+};
+
+const char* GetTargetingStrategyName(TargetingStrategy strategy);
+
 class AIPlayer {
 public:
     AIPlayer();
+    // Deterministic AI for simulations: same seed, same placements and shots
+    explicit AIPlayer(uint64_t seed);
+    
+    void SetSeed(uint64_t seed);
     
     void Reset();
     void InitializeAI();
     
+    // Draws the next fleet layout, which takes milliseconds for the full fleet.
+    // PlaceShips draws one itself unless this ran since the last SetSeed, so a
+    // front end can call it off its own thread and keep StartBattle instant.
+    void PrepareShips();
     void PlaceShips(Grid& aiGrid);
-    GridPosition GetTarget(const Grid& playerGrid);
+    // observer, if given, follows the endgame and Hard searches and may stop
+    // them early; the cell returned is then their best so far
+    GridPosition GetTarget(const Grid& playerGrid, SearchObserver* observer = nullptr);
+    
+    // What GetTarget remembers between shots: Random's probe queue and last
+    // hit. A caller that drops a move instead of playing it restores this.
+    struct HuntState {
+        GridPosition lastHit;
+        std::vector<GridPosition> targetQueue;
+    };
+    HuntState SaveHuntState() const { return {lastHit, targetQueue}; }
+    void RestoreHuntState(HuntState state) {
+        lastHit = state.lastHit;
+        targetQueue = std::move(state.targetQueue);
+    }
     
     void SetLastHit(GridPosition hit) { lastHit = hit; }
     void ClearLastHit() { lastHit = GridPosition(-1, -1); }
     void ClearTargetQueue() { targetQueue.clear(); }
+    void NotifyShipSunk(const BitBoard& shipCells);
+    
+    TargetingStrategy GetTargetingStrategy() const { return targetingStrategy; }
+    void SetTargetingStrategy(TargetingStrategy strategy) { targetingStrategy = strategy; }
+    void SetMonteCarloTimeBudget(std::chrono::microseconds budget);
+    void SetMonteCarloThreadCount(int threads) { monteCarloThreads = threads; } // 0 = all cores
+    
+    // Progress messages on stdout; simulations turn them off
+    void SetVerbose(bool enabled) { verbose = enabled; }
+    
+    // Exact endgame search for the Density and Hard strategies
+    void SetEndgameEnabled(bool enabled) { endgameEnabled = enabled; }
+    bool IsEndgameEnabled() const { return endgameEnabled; }
+    const EndgameSolver& GetEndgameSolver() const { return endgameSolver; }
     
     ShipManager& GetShipManager() { return shipManager; }
     const ShipManager& GetShipManager() const { return shipManager; }
@@ -28,6 +79,27 @@ private:
     GridPosition lastHit;
     std::vector<GridPosition> targetQueue;
     std::mt19937 randomGenerator;
+    UniformFleetSampler fleetSampler;
+    TargetingStrategy targetingStrategy;
+    std::unique_ptr<MonteCarloTargeting> monteCarlo; // Thread pool, created on first use
+    std::chrono::microseconds monteCarloBudget;
+    int monteCarloThreads;
+    EndgameSolver endgameSolver;
+    bool endgameEnabled;
+    bool verbose;
+    std::array<ShipPlacement, MAX_FLEET_SIZE> preparedShips;
+    bool shipsPrepared;
+    
+    // Opponent ships sunk so far; their fleet has the same make-up as ours
+    BitBoard sunkCells;
+    std::array<int, MAX_SHIP_SIZE + 1> opponentShipsAfloat;
+    
+    void ResetOpponentFleet();
+    GridPosition GetRandomAdjacentTarget(const Grid& playerGrid);
+    TargetingView BuildTargetingView(const Grid& playerGrid) const;
+    GridPosition GetDensityTarget(const Grid& playerGrid);
+    GridPosition GetMonteCarloTarget(const Grid& playerGrid, SearchObserver* observer);
+    bool GetEndgameTarget(const Grid& playerGrid, GridPosition& target, SearchObserver* observer);
     
     bool IsValidShipPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) const;
     void PlaceShip(Grid& grid, int startX, int startY, int shipSize, bool horizontal) const;
@@ -0,0 +1,165 @@
+#include "AIThinker.h"
+#include "Grid.h"
+#include <utility>
+
+AIThinker::AIThinker(AIPlayer& player) : player(player) {
+    worker = std::thread(&AIThinker::Run, this);
+}
+
+AIThinker::~AIThinker() {
+    stopping.store(true, std::memory_order_release);
+    wakeups.fetch_add(1, std::memory_order_release);
+    wakeups.notify_one();
+    worker.join();
+}
+
+void AIThinker::PostPlacement(uint64_t seed) {
+    Enqueue(Request{BitBoard(), BitBoard(), BitBoard(), GridPosition(-1, -1), seed, 0, true, false});
+}
+
+void AIThinker::Post(const BitBoard& hits, const BitBoard& misses, GridPosition lastHit, const BitBoard& sunkShips) {
+    Enqueue(Request{hits, misses, sunkShips, lastHit, 0, 0, false, true});
+}
+
+void AIThinker::Hurry() {
+    Flush();
+    hurriedId.store(postedId.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void AIThinker::Enqueue(Request request) {
+    request.id = postedId.load(std::memory_order_relaxed) + 1;
+    postedId.store(request.id, std::memory_order_release);
+    Flush();
+    if (hasOverflow) {
+        // Replace the waiting request rather than wait for room. A new fleet
+        // starts a new game and supersedes it; a move keeps its fleet and
+        // what its shot revealed.
+        if (!request.place) {
+            if (overflow.place) {
+                request.place = true;
+                request.seed = overflow.seed;
+            }
+            request.sunkShips |= overflow.sunkShips;
+            if (request.lastHit.x < 0) {
+                request.lastHit = overflow.lastHit;
+            }
+        }
+        overflow = request;
+    } else if (!requests.TryPush(request)) {
+        overflow = request;
+        hasOverflow = true;
+    }
+    wakeups.fetch_add(1, std::memory_order_release);
+    wakeups.notify_one();
+}
+
+// Moves the waiting request into the ring once there is room
+void AIThinker::Flush() {
+    if (hasOverflow && requests.TryPush(overflow)) {
+        hasOverflow = false;
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_one();
+    }
+}
+
+AIThinker::MoveKind AIThinker::GetMove(GridPosition& target) {
+    Flush();
+    uint64_t packed = move.load(std::memory_order_acquire);
+    if ((uint32_t)(packed >> 32) != postedId.load(std::memory_order_relaxed)) {
+        return MoveKind::None;
+    }
+    int cell = (int)(packed & 0xFF);
+    target = GridPosition(cell % GRID_SIZE, cell / GRID_SIZE);
+    return (MoveKind)((packed >> 8) & 0xFF);
+}
+
+void AIThinker::WaitUntilIdle() {
+    while (true) {
+        Flush();
+        uint32_t finished = finishedId.load(std::memory_order_acquire);
+        if (finished == postedId.load(std::memory_order_relaxed)) {
+            return;
+        }
+        finishedId.wait(finished, std::memory_order_acquire);
+    }
+}
+
+void AIThinker::Run() {
+    while (true) {
+        // Read before draining, so a post that lands after the ring looked
+        // empty still changes the value waited on below
+        uint32_t seen = wakeups.load(std::memory_order_acquire);
+        Request request;
+        while (requests.TryPop(request)) {
+            if (request.place) {
+                player.SetSeed(request.seed);
+                player.PrepareShips();
+            }
+            if (request.think) {
+                // A newer request makes this move moot, but not what its shot revealed
+                Learn(request);
+                if (request.id == postedId.load(std::memory_order_acquire)) {
+                    Think(request);
+                }
+            }
+            finishedId.store(request.id, std::memory_order_release);
+            finishedId.notify_all();
+        }
+        if (stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+        wakeups.wait(seen, std::memory_order_acquire);
+    }
+}
+
+// What the AI's previous shots revealed, in the order the game loop used to report it
+void AIThinker::Learn(const Request& request) {
+    if (request.lastHit.x >= 0) {
+        player.SetLastHit(request.lastHit);
+    }
+    // Ships never touch, not even at a corner, so each group of touching cells is one ship
+    for (BitBoard remaining = request.sunkShips; remaining.Any();) {
+        BitBoard ship = BitBoard::Cell(remaining.LowestIndex());
+        for (BitBoard grown = ship.Dilate() & remaining; !(grown == ship); grown = ship.Dilate() & remaining) {
+            ship = grown;
+        }
+        player.NotifyShipSunk(ship);
+        remaining &= ~ship;
+    }
+}
+
+void AIThinker::Think(const Request& request) {
+    // The AI only ever sees shot results, never the ships themselves
+    Grid board;
+    for (BitBoard cells = request.hits; cells.Any();) {
+        int index = cells.PopLowest();
+        board.SetCell(index % GRID_SIZE, index / GRID_SIZE, CellState::Hit);
+    }
+    for (BitBoard cells = request.misses; cells.Any();) {
+        int index = cells.PopLowest();
+        board.SetCell(index % GRID_SIZE, index / GRID_SIZE, CellState::Miss);
+    }
+
+    thinkingId = request.id;
+    AIPlayer::HuntState saved = player.SaveHuntState();
+    GridPosition target = player.GetTarget(board, this);
+    if (request.id != postedId.load(std::memory_order_acquire)) {
+        // Superseded while searching, so this move is never played
+        player.RestoreHuntState(std::move(saved));
+        return;
+    }
+    Publish(request.id, MoveKind::Final, BitBoard::CellIndex(target.x, target.y));
+}
+
+void AIThinker::OnBestSoFar(int cell) {
+    Publish(thinkingId, MoveKind::BestSoFar, cell);
+}
+
+bool AIThinker::ShouldStop() {
+    return postedId.load(std::memory_order_relaxed) != thinkingId ||
+           hurriedId.load(std::memory_order_relaxed) == thinkingId;
+}
+
+void AIThinker::Publish(uint32_t id, MoveKind kind, int cell) {
+    move.store((uint64_t)id << 32 | (uint64_t)kind << 8 | (uint64_t)cell, std::memory_order_release);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "AIPlayer.h"
+#include "BitBoard.h"
+#include "GameState.h"
+#include "SpscRing.h"
+
+// Runs an AIPlayer's decisions on a worker thread so a slow targeting strategy
+// never stalls the caller. The caller posts what the AI may see of its target
+// board: the shots so far, plus what its previous shot revealed. While the
+// strategy searches, the worker publishes the search's best move so far, then
+// its choice. A caller out of time calls Hurry: the search stops at its next
+// check and makes its best so far its choice, so the move played is always one
+// the AI decided on. Requests travel through an SPSC ring, and moves come back
+// through one atomic word, so neither side ever takes a lock or waits to post.
+//
+// While requests are outstanding the AIPlayer belongs to the worker; call
+// WaitUntilIdle before touching it directly.
+class AIThinker : private SearchObserver {
+public:
+    enum class MoveKind : uint8_t {
+        None,       // Nothing published for the latest request yet
+        BestSoFar,  // The search's current best; it is still running
+        Final,      // The strategy's choice
+    };
+
+    explicit AIThinker(AIPlayer& player);
+    ~AIThinker();
+
+    AIThinker(const AIThinker&) = delete;
+    AIThinker& operator=(const AIThinker&) = delete;
+
+    // Has the worker draw the AI's fleet for a game with this seed (see
+    // AIPlayer::PrepareShips); wait until idle before placing it
+    void PostPlacement(uint64_t seed);
+
+    // Asks for a move against a board with these shots. lastHit is the AI's
+    // previous shot if it hit, else (-1, -1); sunkShips holds the cells of the
+    // ships sunk since the previous request. A search still running for an
+    // earlier request is cut short, and its move and what it changed in the
+    // AI's hunt state are dropped.
+    void Post(const BitBoard& hits, const BitBoard& misses, GridPosition lastHit, const BitBoard& sunkShips);
+
+    // Asks the search for the latest request to finish with its best so far
+    void Hurry();
+
+    // Newest move for the latest request; never blocks
+    MoveKind GetMove(GridPosition& move);
+
+    // Blocks until the worker has finished every request posted so far
+    void WaitUntilIdle();
+
+private:
+    struct Request {
+        BitBoard hits;
+        BitBoard misses;
+        BitBoard sunkShips;
+        GridPosition lastHit;
+        uint64_t seed;  // Placement only
+        uint32_t id;
+        bool place;     // Draw the fleet for seed first
+        bool think;     // Then learn what the last shot revealed and choose a move
+    };
+
+    AIPlayer& player;
+
+    SpscRing<Request, 4> requests;
+    Request overflow;          // Caller only: a request that found the ring full
+    bool hasOverflow = false;
+    std::atomic<uint32_t> wakeups{0};
+    std::atomic<bool> stopping{false};
+    std::atomic<uint32_t> postedId{0};  // Written by the caller only
+    std::atomic<uint32_t> hurriedId{0};
+    std::atomic<uint32_t> finishedId{0};
+    std::atomic<uint64_t> move{0};      // Request id << 32 | kind << 8 | cell
+    uint32_t thinkingId = 0;            // Worker only: the request being searched for
+    std::thread worker;
+
+    void Run();
+    void Enqueue(Request request);
+    void Flush();
+    void Learn(const Request& request);
+    void Think(const Request& request);
+    void Publish(uint32_t id, MoveKind kind, int cell);
+
+    // SearchObserver, called on the worker while it searches
+    void OnBestSoFar(int cell) override;
+    bool ShouldStop() override;
+};
@@ -0,0 +1,162 @@
+#include "BatchedEnv.h"
+#include "FleetGenerator.h"
+#include "Ship.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace {
+
+int ResolveThreadCount(int threadCount, int shardCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    return std::clamp(threadCount, 1, std::max(1, shardCount));
+}
+
+uint8_t* Plane(uint8_t* observation, ObservationPlane plane) {
+    return observation + (int)plane * BatchedEnv::CELL_COUNT;
+}
+
+} // namespace
+
+BatchedEnv::BatchedEnv(int envCount, uint64_t seed, int threadCount)
+    : envCount(std::max(0, envCount)), seed(seed),
+      startBarrier(ResolveThreadCount(threadCount, (this->envCount + SHARD_SIZE - 1) / SHARD_SIZE)),
+      doneBarrier(ResolveThreadCount(threadCount, (this->envCount + SHARD_SIZE - 1) / SHARD_SIZE)) {
+    ShipManager shipManager;
+    for (const Ship& ship : shipManager.GetShips()) {
+        fleet.push_back(ship.size);
+    }
+    games.resize(this->envCount);
+    observations.resize((size_t)this->envCount * OBSERVATION_SIZE);
+    rewards.resize(this->envCount);
+    statuses.resize(this->envCount);
+    episodeLengths.resize(this->envCount);
+
+    int shardCount = (this->envCount + SHARD_SIZE - 1) / SHARD_SIZE;
+    shards.resize(shardCount);
+    for (int i = 0; i < shardCount; ++i) {
+        shards[i].begin = i * SHARD_SIZE;
+        shards[i].end = std::min(this->envCount, (i + 1) * SHARD_SIZE);
+    }
+    Reset();
+
+    int workerCount = ResolveThreadCount(threadCount, shardCount);
+    for (int worker = 1; worker < workerCount; ++worker) {
+        workers.emplace_back(&BatchedEnv::RunWorker, this, worker);
+    }
+}
+
+BatchedEnv::~BatchedEnv() {
+    stopping = true;
+    if (!workers.empty()) {
+        startBarrier.arrive_and_wait();
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void BatchedEnv::Reset() {
+    for (size_t i = 0; i < shards.size(); ++i) {
+        Shard& shard = shards[i];
+        shard.rng.seed((uint32_t)(seed ^ (seed >> 32)) + (uint32_t)i * 0x9E3779B9u);
+        for (int env = shard.begin; env < shard.end; ++env) {
+            ResetGame(env, shard.rng);
+            rewards[env] = 0.0f;
+            statuses[env] = StepStatus::Running;
+            episodeLengths[env] = 0;
+        }
+    }
+}
+
+bool BatchedEnv::Step(std::span<const int32_t> actions) {
+    if ((int)actions.size() != envCount) {
+        return false;
+    }
+    pendingActions = actions.data();
+    if (workers.empty()) {
+        StepShards(0);
+        return true;
+    }
+    startBarrier.arrive_and_wait();
+    StepShards(0);
+    doneBarrier.arrive_and_wait();
+    return true;
+}
+
+void BatchedEnv::RunWorker(int worker) {
+    while (true) {
+        startBarrier.arrive_and_wait();
+        if (stopping) return;
+        StepShards(worker);
+        doneBarrier.arrive_and_wait();
+    }
+}
+
+void BatchedEnv::StepShards(int worker) {
+    int workerCount = (int)workers.size() + 1;
+    for (size_t i = worker; i < shards.size(); i += workerCount) {
+        Shard& shard = shards[i];
+        for (int env = shard.begin; env < shard.end; ++env) {
+            StepGame(env, pendingActions[env], shard.rng);
+        }
+    }
+}
+
+void BatchedEnv::StepGame(int env, int32_t action, std::mt19937& rng) {
+    Game& game = games[env];
+    uint8_t* observation = &observations[(size_t)env * OBSERVATION_SIZE];
+    game.shots++;
+    rewards[env] = REWARD_PER_SHOT;
+
+    // Only the fired-at cell changes, plus the ship's cells when it sinks
+    if (action >= 0 && action < CELL_COUNT && Plane(observation, ObservationPlane::Unknown)[action]) {
+        Plane(observation, ObservationPlane::Unknown)[action] = 0;
+        ShotResult result = game.grid.ReceiveShot(action % GRID_SIZE, action / GRID_SIZE);
+        if (result == ShotResult::Miss) {
+            Plane(observation, ObservationPlane::Miss)[action] = 1;
+        } else {
+            Plane(observation, ObservationPlane::Hit)[action] = 1;
+        }
+        if (result == ShotResult::Sunk) {
+            uint8_t* sunk = Plane(observation, ObservationPlane::Sunk);
+            for (BitBoard cells = game.grid.GetShipCells(game.grid.GetShipId(action % GRID_SIZE, action / GRID_SIZE));
+                 cells.Any();) {
+                sunk[cells.PopLowest()] = 1;
+            }
+        }
+    }
+
+    StepStatus status = StepStatus::Running;
+    if (game.grid.CountRemainingShips() == 0) {
+        status = StepStatus::FleetSunk;
+    } else if (game.shots >= MAX_EPISODE_STEPS) {
+        status = StepStatus::Truncated;
+    }
+    statuses[env] = status;
+    if (status != StepStatus::Running) {
+        episodeLengths[env] = game.shots;
+        ResetGame(env, rng);
+    }
+}
+
+void BatchedEnv::ResetGame(int env, std::mt19937& rng) {
+    Game& game = games[env];
+    game.grid.Reset();
+    game.shots = 0;
+
+    // The backtracking generator: uniform sampling costs ~10 ms per fleet,
+    // far more than the episode itself
+    std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+    std::span<ShipPlacement> layout(placements.data(), fleet.size());
+    GenerateRandomFleet(fleet, rng, layout);
+    for (const ShipPlacement& placement : layout) {
+        game.grid.PlaceShip(placement.x, placement.y, placement.size, placement.horizontal);
+    }
+
+    uint8_t* observation = &observations[(size_t)env * OBSERVATION_SIZE];
+    std::memset(observation, 0, OBSERVATION_SIZE);
+    std::memset(Plane(observation, ObservationPlane::Unknown), 1, CELL_COUNT);
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <barrier>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+#include "Grid.h"
+
+// Observation planes, one byte (0 or 1) per cell
+enum class ObservationPlane {
+    Hit = 0,
+    Miss,
+    Unknown, // Not fired at yet
+    Sunk,    // Hits on ships that have gone down
+    Count
+};
+
+enum class StepStatus : uint8_t {
+    Running = 0,
+    FleetSunk = 1,
+    Truncated = 2, // Hit the step limit, e.g. a policy stuck on fired-at cells
+};
+
+// Many independent single-player games stepped together, for training
+// targeting policies against the real rules. Each game hides a random fleet
+// and every Step fires one shot into each game.
+//
+// Observations, rewards and statuses live in flat arrays owned by the
+// environment and updated in place: observations in [env][plane][cell] order,
+// the rest one entry per game. A caller can wrap them once (see the C API in
+// BattleshipEnv.h) and read them after every Step without copying. A game
+// that ends is reset with a fresh fleet inside the same Step: its status and
+// episode length describe the finished game, its observation the new one.
+//
+// Games are split into fixed shards, each with its own random source and
+// always stepped by the same worker, so results depend only on the seed and
+// the actions, not on the thread count. Stepping allocates nothing.
+class BatchedEnv {
+public:
+    static constexpr int CELL_COUNT = GRID_SIZE * GRID_SIZE;
+    static constexpr int PLANE_COUNT = (int)ObservationPlane::Count;
+    static constexpr int OBSERVATION_SIZE = PLANE_COUNT * CELL_COUNT;
+    static constexpr float REWARD_PER_SHOT = -1.0f; // An episode returns minus its length
+    static constexpr int MAX_EPISODE_STEPS = 2 * CELL_COUNT;
+
+    // threadCount 0 uses every core
+    BatchedEnv(int envCount, uint64_t seed, int threadCount = 1);
+    ~BatchedEnv();
+
+    BatchedEnv(const BatchedEnv&) = delete;
+    BatchedEnv& operator=(const BatchedEnv&) = delete;
+
+    // Starts every game over with a fresh fleet
+    void Reset();
+    // actions[i] is the cell y * GRID_SIZE + x to fire at in game i. A cell
+    // that was already fired at, or is off the board, wastes the shot.
+    // False if there is not exactly one action per game.
+    bool Step(std::span<const int32_t> actions);
+
+    int GetEnvCount() const { return envCount; }
+    const uint8_t* GetObservations() const { return observations.data(); }
+    const float* GetRewards() const { return rewards.data(); }
+    const StepStatus* GetStatuses() const { return statuses.data(); }
+    // Shots the game took, for games whose status is not Running
+    const uint16_t* GetEpisodeLengths() const { return episodeLengths.data(); }
+
+private:
+    static constexpr int SHARD_SIZE = 64;
+
+    struct Game {
+        Grid grid;
+        uint16_t shots;
+    };
+    struct alignas(64) Shard {
+        std::mt19937 rng;
+        int begin;
+        int end;
+    };
+
+    int envCount;
+    uint64_t seed;
+    std::vector<int> fleet;
+    std::vector<Game> games;
+    std::vector<Shard> shards;
+
+    std::vector<uint8_t> observations;
+    std::vector<float> rewards;
+    std::vector<StepStatus> statuses;
+    std::vector<uint16_t> episodeLengths;
+
+    // Workers 1.. run in their own threads; the caller of Step is worker 0
+    std::vector<std::thread> workers;
+    std::barrier<> startBarrier;
+    std::barrier<> doneBarrier;
+    const int32_t* pendingActions = nullptr;
+    bool stopping = false;
+
+    void RunWorker(int worker);
+    void StepShards(int worker);
+    void StepGame(int env, int32_t action, std::mt19937& rng);
+    void ResetGame(int env, std::mt19937& rng);
+};
@@ -0,0 +1,54 @@
+#include "BattleshipEnv.h"
+#include "BatchedEnv.h"
+
+static_assert(BATTLESHIP_ENV_PLANES == BatchedEnv::PLANE_COUNT && BATTLESHIP_ENV_CELLS == BatchedEnv::CELL_COUNT,
+              "keep the C header in step with BatchedEnv");
+static_assert(sizeof(StepStatus) == sizeof(uint8_t));
+
+struct BattleshipEnv {
+    BatchedEnv env;
+
+    BattleshipEnv(int envCount, uint64_t seed, int threadCount) : env(envCount, seed, threadCount) {}
+};
+
+BattleshipEnv* BattleshipEnv_Create(int env_count, uint64_t seed, int thread_count) {
+    if (env_count <= 0) return nullptr;
+    // No exceptions may cross into C
+    try {
+        return new BattleshipEnv(env_count, seed, thread_count);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void BattleshipEnv_Destroy(BattleshipEnv* env) {
+    delete env;
+}
+
+void BattleshipEnv_Reset(BattleshipEnv* env) {
+    env->env.Reset();
+}
+
+int BattleshipEnv_Step(BattleshipEnv* env, const int32_t* actions) {
+    return env->env.Step({actions, (size_t)env->env.GetEnvCount()}) ? 0 : -1;
+}
+
+int BattleshipEnv_GetEnvCount(const BattleshipEnv* env) {
+    return env->env.GetEnvCount();
+}
+
+const uint8_t* BattleshipEnv_GetObservations(const BattleshipEnv* env) {
+    return env->env.GetObservations();
+}
+
+const float* BattleshipEnv_GetRewards(const BattleshipEnv* env) {
+    return env->env.GetRewards();
+}
+
+const uint8_t* BattleshipEnv_GetStatuses(const BattleshipEnv* env) {
+    return reinterpret_cast<const uint8_t*>(env->env.GetStatuses());
+}
+
+const uint16_t* BattleshipEnv_GetEpisodeLengths(const BattleshipEnv* env) {
+    return env->env.GetEpisodeLengths();
+}
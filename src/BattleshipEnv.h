@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+/* C interface to BatchedEnv, built as the battleship_env shared library for
+   use from Python (ctypes/cffi) and other languages. The buffer pointers stay
+   valid until the environment is destroyed and are updated in place by every
+   step, so they can be wrapped once, e.g. with numpy.ctypeslib.as_array:
+
+       observations  uint8   [env_count][BATTLESHIP_ENV_PLANES][BATTLESHIP_ENV_CELLS]
+                     planes: hit, miss, unknown, sunk
+       rewards       float   [env_count]
+       statuses      uint8   [env_count]  0 running, 1 fleet sunk, 2 truncated
+       lengths       uint16  [env_count]  shots of a game that just ended
+
+   Actions are int32 cells, y * 10 + x, one per game. */
+
+#ifdef _WIN32
+#ifdef BATTLESHIP_ENV_EXPORTS
+#define BATTLESHIP_ENV_API __declspec(dllexport)
+#else
+#define BATTLESHIP_ENV_API __declspec(dllimport)
+#endif
+#else
+#define BATTLESHIP_ENV_API __attribute__((visibility("default")))
+#endif
+
+#define BATTLESHIP_ENV_PLANES 4
+#define BATTLESHIP_ENV_CELLS 100
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct BattleshipEnv BattleshipEnv;
+
+/* thread_count 0 uses every core. Returns NULL on failure. */
+BATTLESHIP_ENV_API BattleshipEnv* BattleshipEnv_Create(int env_count, uint64_t seed, int thread_count);
+BATTLESHIP_ENV_API void BattleshipEnv_Destroy(BattleshipEnv* env);
+
+BATTLESHIP_ENV_API void BattleshipEnv_Reset(BattleshipEnv* env);
+/* actions holds env_count cells. Returns 0 on success. */
+BATTLESHIP_ENV_API int BattleshipEnv_Step(BattleshipEnv* env, const int32_t* actions);
+
+BATTLESHIP_ENV_API int BattleshipEnv_GetEnvCount(const BattleshipEnv* env);
+BATTLESHIP_ENV_API const uint8_t* BattleshipEnv_GetObservations(const BattleshipEnv* env);
+BATTLESHIP_ENV_API const float* BattleshipEnv_GetRewards(const BattleshipEnv* env);
+BATTLESHIP_ENV_API const uint8_t* BattleshipEnv_GetStatuses(const BattleshipEnv* env);
+BATTLESHIP_ENV_API const uint16_t* BattleshipEnv_GetEpisodeLengths(const BattleshipEnv* env);
+
+#ifdef __cplusplus
+}
+#endif
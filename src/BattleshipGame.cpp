@@ -1,18 +1,21 @@
 #include "BattleshipGame.h"
-#include <iostream>
+#include "Log.h"
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
 
 BattleshipGame::BattleshipGame() 
-    : window(nullptr), sdlRenderer(nullptr), isRunning(false),
-      mouseGridPos(-1, -1), playAgainButton{0, 0, 0, 0}, playAgainButtonHovered(false),
-      aiTurnDelay(0) {
-    
-    // Initialize components
-    gameState = std::make_unique<GameState>();
-    playerGrid = std::make_unique<Grid>();
-    targetGrid = std::make_unique<Grid>();
-    aiGrid = std::make_unique<Grid>();
-    shipManager = std::make_unique<ShipManager>();
+    : window(nullptr), sdlRenderer(nullptr), isRunning(false), needsRedraw(true),
+      mouseGridPos(-1, -1), previewGridPos(-1, -1), playAgainButton{0, 0, 0, 0}, playAgainButtonHovered(false),
+      gameSeed(0), replayShotIndex(0), replayDeadline(0), replaying(false), aiTurnStart(0), aiTurnDeadline(0),
+      aiThinkDeadline(0), thinkingPhase(0), aiFeedbackHit(-1, -1) {
+    
     aiPlayer = std::make_unique<AIPlayer>();
+    aiThinker = std::make_unique<AIThinker>(*aiPlayer);
+    
+    std::random_device rd;
+    randomGenerator.seed(rd());
+    PrepareAIFleet();
 }
 
 BattleshipGame::~BattleshipGame() {
@@ -21,7 +24,7 @@ BattleshipGame::~BattleshipGame() {
 
 bool BattleshipGame::Initialize() {
     if (!SDL_Init(SDL_INIT_VIDEO)) {
-        std::cerr << "SDL3 failed to initialize: " << SDL_GetError() << std::endl;
+        LOG_ERROR(LogCategory::Game, "SDL3 failed to initialize: {}", SDL_GetError());
         return false;
     }
     
@@ -29,13 +32,13 @@ bool BattleshipGame::Initialize() {
                              WINDOW_WIDTH, WINDOW_HEIGHT, 
                              SDL_WINDOW_RESIZABLE);
     if (!window) {
-        std::cerr << "Failed to create window: " << SDL_GetError() << std::endl;
+        LOG_ERROR(LogCategory::Game, "Failed to create window: {}", SDL_GetError());
         return false;
     }
     
     sdlRenderer = SDL_CreateRenderer(window, nullptr);
     if (!sdlRenderer) {
-        std::cerr << "Failed to create renderer: " << SDL_GetError() << std::endl;
+        LOG_ERROR(LogCategory::Game, "Failed to create renderer: {}", SDL_GetError());
         return false;
     }
     
@@ -49,15 +52,114 @@ bool BattleshipGame::Initialize() {
     return true;
 }
 
+bool BattleshipGame::StartRecording(const std::string& path) {
+    if (!recorder.Open(path)) {
+        LOG_ERROR(LogCategory::Game, "Cannot create game record {}", path);
+        return false;
+    }
+    LOG_INFO(LogCategory::Game, "Recording games to {}", path);
+    return true;
+}
+
+bool BattleshipGame::LoadReplay(const std::string& path, int gameIndex, int shotIndex) {
+    RestartGame();
+    std::string error;
+    if (!replayFile.Open(path, error)) {
+        LOG_ERROR(LogCategory::Game, "{}", error);
+        return false;
+    }
+    
+    // The game index takes us straight to the game; it is built on first use
+    std::span<const uint8_t> records = replayFile.GetBytes();
+    std::string indexPath = GetGameIndexPath(path);
+    GameIndex index;
+    if (!index.Open(indexPath, records.size(), error)) {
+        LOG_INFO(LogCategory::Game, "Indexing {} ({})", path, error);
+        if (!BuildGameIndex(records, indexPath, error) || !index.Open(indexPath, records.size(), error)) {
+            LOG_ERROR(LogCategory::Game, "Cannot index {}: {}", path, error);
+            replayFile.Close();
+            return false;
+        }
+    }
+    if (gameIndex < 0 || shotIndex < 0 ||
+        !SeekRecordedGame(index, records, (uint32_t)gameIndex, shotIndex, model.match, replayGame)) {
+        LOG_ERROR(LogCategory::Game, "{} has no shot {} in game {}", path, shotIndex, gameIndex);
+        RestartGame();
+        return false;
+    }
+    
+    // The player's view of the AI grid is otherwise built up shot by shot
+    const Grid& aiGrid = AIGrid();
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            CellState cell = aiGrid.GetCell(x, y);
+            if (cell == CellState::Hit || cell == CellState::Miss) {
+                model.targetGrid.SetCell(x, y, cell);
+            }
+        }
+    }
+    model.fleet.SetCurrentShipIndex((int)model.fleet.GetShips().size());
+    replaying = true;
+    replayShotIndex = shotIndex;
+    replayDeadline = SDL_GetTicks() + AI_TURN_DELAY_MS;
+    LOG_INFO(LogCategory::Game, "Replaying game {} of {} from shot {}: seed {}, {} shots", gameIndex, path, shotIndex,
+             replayGame.seed, replayGame.GetShotCount());
+    return true;
+}
+
 void BattleshipGame::Run() {
     while (isRunning) {
-        HandleEvents();
-        Update();
-        Render();
+        // Sleep until input arrives or the pending AI move is due
+        SDL_WaitEventTimeout(nullptr, GetEventWaitTimeout());
+        
+        {
+            // The wait above is idle time, not part of the frame
+            ProfileScope frameScope(profiler, ProfilePhase::Frame);
+            {
+                ProfileScope scope(profiler, ProfilePhase::HandleEvents);
+                HandleEvents();
+            }
+            {
+                ProfileScope scope(profiler, ProfilePhase::Update);
+                Update();
+            }
+            
+            // Only redraw when something visible has changed
+            if (needsRedraw) {
+                Render();
+                needsRedraw = false;
+            }
+        }
+        if (profiler.IsEnabled()) {
+            profiler.EndFrame();
+        }
+    }
+}
+
+Sint32 BattleshipGame::GetEventWaitTimeout() const {
+    if (replaying) {
+        if (model.match.IsOver() || replayShotIndex >= replayGame.GetShotCount()) return -1;
+        Uint64 now = SDL_GetTicks();
+        return now >= replayDeadline ? 0 : (Sint32)(replayDeadline - now);
+    }
+    if (IsAITurnPending()) {
+        Uint64 now = SDL_GetTicks();
+        if (now >= aiTurnDeadline) {
+            // Poll the search every frame until it hands over its move; past the
+            // think deadline ProcessAITurn hurries it along
+            GridPosition move;
+            return aiThinker->GetMove(move) == AIThinker::MoveKind::Final ? 0 : FRAME_MS;
+        }
+        // Wake for every step of the thinking indicator
+        Uint64 nextDot = THINKING_DOT_MS - (now - aiTurnStart) % THINKING_DOT_MS;
+        return (Sint32)std::min(aiTurnDeadline - now, nextDot);
     }
+    return -1; // Nothing scheduled, wait for input indefinitely
 }
 
 void BattleshipGame::Cleanup() {
+    // The renderer's textures have to go before the SDL renderer that owns them
+    renderer.reset();
     if (sdlRenderer) {
         SDL_DestroyRenderer(sdlRenderer);
         sdlRenderer = nullptr;
@@ -76,41 +178,55 @@ void BattleshipGame::HandleEvents() {
             case SDL_EVENT_QUIT:
                 isRunning = false;
                 break;
+            case SDL_EVENT_WINDOW_EXPOSED:
+            case SDL_EVENT_WINDOW_RESIZED:
+            case SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED:
+                needsRedraw = true;
+                break;
             case SDL_EVENT_MOUSE_BUTTON_DOWN:
                 if (event.button.button == SDL_BUTTON_LEFT) {
-                    if (gameState->GetState() == GameStateType::ShipPlacement) {
+                    if (model.match.GetGameState().GetState() == GameStateType::ShipPlacement) {
                         HandleShipPlacementClick(event.button.x, event.button.y);
-                    } else if (gameState->GetState() == GameStateType::Battle) {
+                    } else if (model.match.GetGameState().GetState() == GameStateType::Battle) {
                         HandleGridClick(event.button.x, event.button.y);
-                    } else if (gameState->GetState() == GameStateType::GameOver) {
+                    } else if (model.match.GetGameState().GetState() == GameStateType::GameOver) {
                         // Check if play again button was clicked
                         if (event.button.x >= playAgainButton.x && 
                             event.button.x <= playAgainButton.x + playAgainButton.w &&
                             event.button.y >= playAgainButton.y && 
                             event.button.y <= playAgainButton.y + playAgainButton.h) {
-                            std::cout << "Play Again button clicked!" << std::endl;
+                            LOG_INFO(LogCategory::Game, "Play Again button clicked!");
                             RestartGame();
                         }
                     }
                 }
                 break;
             case SDL_EVENT_MOUSE_MOTION:
-                if (gameState->GetState() == GameStateType::ShipPlacement) {
+                if (model.match.GetGameState().GetState() == GameStateType::ShipPlacement) {
                     UpdateShipPreview(event.motion.x, event.motion.y);
-                } else if (gameState->GetState() == GameStateType::GameOver) {
+                } else if (model.match.GetGameState().GetState() == GameStateType::GameOver) {
                     // Check if mouse is over play again button
-                    playAgainButtonHovered = (event.motion.x >= playAgainButton.x && 
-                                            event.motion.x <= playAgainButton.x + playAgainButton.w &&
-                                            event.motion.y >= playAgainButton.y && 
-                                            event.motion.y <= playAgainButton.y + playAgainButton.h);
+                    bool hovered = (event.motion.x >= playAgainButton.x && 
+                                    event.motion.x <= playAgainButton.x + playAgainButton.w &&
+                                    event.motion.y >= playAgainButton.y && 
+                                    event.motion.y <= playAgainButton.y + playAgainButton.h);
+                    if (hovered != playAgainButtonHovered) {
+                        playAgainButtonHovered = hovered;
+                        needsRedraw = true;
+                    }
                 }
                 break;
             case SDL_EVENT_KEY_DOWN:
                 if (event.key.key == SDLK_ESCAPE) {
                     isRunning = false;
-                } else if (gameState->GetState() == GameStateType::ShipPlacement) {
+                } else if (event.key.key == SDLK_F3) {
+                    profiler.SetOverlayVisible(!profiler.IsOverlayVisible());
+                    needsRedraw = true;
+                } else if (event.key.key == SDLK_F4) {
+                    ToggleTrace();
+                } else if (model.match.GetGameState().GetState() == GameStateType::ShipPlacement) {
                     HandleShipPlacementKeyboard(event.key.key);
-                } else if (gameState->GetState() == GameStateType::GameOver && event.key.key == SDLK_SPACE) {
+                } else if (model.match.GetGameState().GetState() == GameStateType::GameOver && event.key.key == SDLK_SPACE) {
                     RestartGame();
                 }
                 break;
@@ -119,14 +235,26 @@ void BattleshipGame::HandleEvents() {
 }
 
 void BattleshipGame::Update() {
+    if (replaying) {
+        ProcessReplayShot();
+        return;
+    }
+    
     // Handle AI turn
-    if (gameState->GetState() == GameStateType::Battle && 
-        !gameState->IsPlayerTurn() && !gameState->IsGameEnded()) {
+    if (IsAITurnPending()) {
         ProcessAITurn();
     }
 }
 
+bool BattleshipGame::IsAITurnPending() const {
+    return !replaying && model.match.GetGameState().GetState() == GameStateType::Battle &&
+           model.match.GetSideToMove() == Side::AI && !model.match.IsOver();
+}
+
 void BattleshipGame::Render() {
+    ProfileScope renderScope(profiler, ProfilePhase::Render);
+    renderer->BeginFrame();
+    
     // Clear screen
     SDL_SetRenderDrawColor(sdlRenderer, 30, 30, 30, 255);
     SDL_RenderClear(sdlRenderer);
@@ -138,28 +266,90 @@ void BattleshipGame::Render() {
     int targetGridY = GRID_MARGIN + 30;
     
     // Render grids
-    playerGrid->Render(renderer.get(), playerGridX, playerGridY, "Your Ships", true);
+    {
+        ProfileScope scope(profiler, ProfilePhase::RenderGrid);
+        renderer->RenderGrid(playerGridX, playerGridY, PlayerGrid().GetGrid(), "Your Ships", true);
+        
+        if (model.match.GetGameState().GetState() == GameStateType::Battle) {
+            renderer->RenderGrid(targetGridX, targetGridY, model.targetGrid.GetGrid(), "Target Grid", false);
+        }
+    }
     
-    if (gameState->GetState() == GameStateType::Battle) {
-        targetGrid->Render(renderer.get(), targetGridX, targetGridY, "Target Grid");
+    if (IsAITurnPending()) {
+        ProfileScope scope(profiler, ProfilePhase::RenderText);
+        renderer->RenderText("AI is thinking" + std::string(thinkingPhase, '.'), targetGridX,
+                             targetGridY + GRID_SIZE * CELL_SIZE + 20);
     }
     
     // Render UI elements
-    if (gameState->GetState() == GameStateType::ShipPlacement) {
+    if (model.match.GetGameState().GetState() == GameStateType::ShipPlacement) {
         int instructionY = GRID_MARGIN + GRID_SIZE * CELL_SIZE + 50;
         int listX = GRID_MARGIN * 2 + GRID_SIZE * CELL_SIZE + GRID_SPACING;
         int listY = GRID_MARGIN + 50;
         
-        renderer->RenderShipPlacementUI(*shipManager, instructionY, listX, listY);
+        {
+            ProfileScope scope(profiler, ProfilePhase::RenderUI);
+            renderer->RenderShipPlacementUI(model.fleet, instructionY, listX, listY);
+        }
+        ProfileScope scope(profiler, ProfilePhase::RenderText);
+        renderer->RenderText("T: AI targeting " + std::string(GetTargetingStrategyName(aiPlayer->GetTargetingStrategy())),
+                             GRID_MARGIN, instructionY + 75);
+    }
+    
+    if (model.match.GetGameState().GetState() == GameStateType::GameOver) {
+        ProfileScope scope(profiler, ProfilePhase::RenderUI);
+        renderer->RenderGameOverUI(model.match.GetGameState().GetVictoryMessage(), playAgainButton, playAgainButtonHovered);
     }
     
-    if (gameState->GetState() == GameStateType::GameOver) {
-        renderer->RenderGameOverUI(gameState->GetVictoryMessage(), playAgainButton, playAgainButtonHovered);
+    if (profiler.IsOverlayVisible()) {
+        ProfileScope scope(profiler, ProfilePhase::RenderText);
+        RenderProfilerOverlay();
     }
     
+    ProfileScope presentScope(profiler, ProfilePhase::Present);
     SDL_RenderPresent(sdlRenderer);
 }
 
+// Draw calls and per-phase times of the frames before this one (F3)
+void BattleshipGame::RenderProfilerOverlay() {
+    constexpr int LINE_HEIGHT = 10;
+    constexpr int PHASE_COUNT = (int)ProfilePhase::Count;
+    renderer->RenderPanel({0, 0, 470, (float)(LINE_HEIGHT * (PHASE_COUNT + 2) + 6)}, {0, 0, 0, 200});
+    
+    std::string header = "Draw calls " + std::to_string(renderer->GetLastFrameDrawCallCount());
+    if (profiler.IsTracing()) {
+        header += "   tracing to " + std::string(TRACE_FILE);
+    }
+    renderer->RenderText(header, 5, 5);
+    renderer->RenderText("Phase ms        last    avg    p95    max  16us-1ms", 5, 5 + LINE_HEIGHT);
+    
+    char line[96];
+    for (int i = 0; i < PHASE_COUNT; ++i) {
+        FrameProfiler::PhaseSummary summary = profiler.Summarize((ProfilePhase)i);
+        std::snprintf(line, sizeof(line), "%-13s %6.2f %6.2f %6.2f %6.2f  ", GetProfilePhaseName((ProfilePhase)i),
+                      summary.lastMs, summary.meanMs, summary.p95Ms, summary.maxMs);
+        
+        // One bar glyph per bucket, scaled to the fullest bucket
+        std::string text = line;
+        int fullest = *std::max_element(summary.histogram.begin(), summary.histogram.end());
+        for (int count : summary.histogram) {
+            int level = fullest ? (count * Renderer::BAR_GLYPH_LEVELS + fullest - 1) / fullest : 0;
+            text += level ? (char)(Renderer::FIRST_BAR_GLYPH + level - 1) : ' ';
+        }
+        renderer->RenderText(text, 5, 5 + LINE_HEIGHT * (i + 2));
+    }
+}
+
+void BattleshipGame::ToggleTrace() {
+    if (profiler.IsTracing()) {
+        profiler.StopTrace();
+        LOG_INFO(LogCategory::Profiler, "Frame trace written to {}", TRACE_FILE);
+    } else if (profiler.StartTrace(TRACE_FILE)) {
+        LOG_INFO(LogCategory::Profiler, "Tracing frames to {} (F4 to stop)", TRACE_FILE);
+    }
+    needsRedraw = true;
+}
+
 void BattleshipGame::HandleShipPlacementClick(int mouseX, int mouseY) {
     // Check if mouse is over player grid
     int playerGridX = GRID_MARGIN;
@@ -167,50 +357,99 @@ void BattleshipGame::HandleShipPlacementClick(int mouseX, int mouseY) {
     
     if (mouseX >= playerGridX && mouseX < playerGridX + GRID_SIZE * CELL_SIZE &&
         mouseY >= playerGridY && mouseY < playerGridY + GRID_SIZE * CELL_SIZE &&
-        !shipManager->AllShipsPlaced()) {
+        !model.fleet.AllShipsPlaced()) {
         
         GridPosition pos = ScreenToGrid(mouseX, mouseY, true);
-        const auto& ships = shipManager->GetShips();
-        int currentShipIndex = shipManager->GetCurrentShipIndex();
+        const auto& ships = model.fleet.GetShips();
+        int currentShipIndex = model.fleet.GetCurrentShipIndex();
         
         // Check if placement is valid
-        if (shipManager->IsValidPlacement(*playerGrid, pos.x, pos.y, 
-                                        ships[currentShipIndex].size, shipManager->IsHorizontal())) {
+        if (model.fleet.IsValidPlacement(PlayerGrid(), pos.x, pos.y, 
+                                        ships[currentShipIndex].size, model.fleet.IsHorizontal())) {
             // Clear preview first
-            playerGrid->ClearPreview();
+            PlayerGrid().ClearPreview();
+            previewGridPos = GridPosition(-1, -1);
+            needsRedraw = true;
             
             // Place the ship
-            shipManager->PlaceShip(*playerGrid, pos.x, pos.y, 
-                                 ships[currentShipIndex].size, shipManager->IsHorizontal());
-            shipManager->GetShips()[currentShipIndex].placed = true;
+            model.match.PlaceShip(Side::Player, pos.x, pos.y, ships[currentShipIndex].size, model.fleet.IsHorizontal());
+            model.fleet.GetShips()[currentShipIndex].placed = true;
             
             // Move to next ship
-            shipManager->MoveToNextShip();
+            model.fleet.MoveToNextShip();
             
             // Check if all ships are placed
-            if (shipManager->AllShipsPlaced()) {
-                gameState->SetState(GameStateType::Battle);
-                aiPlayer->PlaceShips(*aiGrid);
-                gameState->SetPlayerShipsRemaining(playerGrid->CountRemainingShips());
-                gameState->SetAIShipsRemaining(aiGrid->CountRemainingShips());
-                std::cout << "All ships placed! Starting battle phase..." << std::endl;
-                std::cout << "Your turn! Click on the right grid to fire." << std::endl;
+            if (model.fleet.AllShipsPlaced()) {
+                StartBattle();
             } else {
-                const auto& currentShip = shipManager->GetShips()[shipManager->GetCurrentShipIndex()];
-                std::cout << "Ship placed! Now place your " << currentShip.name 
-                         << " (" << currentShip.size << " cells)" << std::endl;
+                int nextShipIndex = model.fleet.GetCurrentShipIndex();
+                LOG_INFO(LogCategory::Game, "Ship placed! Now place your {} ({} cells)",
+                         ShipManager::GetShipName(nextShipIndex), model.fleet.GetShips()[nextShipIndex].size);
             }
         }
     }
 }
 
+// The AI draws its fleet while the player is still placing theirs
+void BattleshipGame::PrepareAIFleet() {
+    // One seed per game, recorded so the AI's side of it can be reproduced
+    gameSeed = (uint64_t)randomGenerator() << 32 | randomGenerator();
+    aiThinker->PostPlacement(gameSeed);
+}
+
+void BattleshipGame::StartBattle() {
+    aiThinker->WaitUntilIdle();
+    aiPlayer->PlaceShips(AIGrid());
+    model.match.StartBattle(Side::Player);
+    if (recorder.IsOpen()) {
+        recorder.BeginGame(gameSeed, Side::Player, model.match);
+    }
+    needsRedraw = true;
+    LOG_INFO(LogCategory::Game, "All ships placed! Starting battle phase...");
+    LOG_INFO(LogCategory::Game, "Your turn! Click on the right grid to fire.");
+}
+
+void BattleshipGame::AutoPlaceRemainingShips() {
+    if (model.fleet.AllShipsPlaced()) return;
+    
+    PlayerGrid().ClearPreview();
+    previewGridPos = GridPosition(-1, -1);
+    
+    if (!model.fleet.PlaceRemainingShipsRandomly(PlayerGrid(), randomGenerator)) {
+        LOG_INFO(LogCategory::Game, "No room left for the remaining ships!");
+        UpdateShipPreviewAtCurrentPosition();
+        return;
+    }
+    
+    LOG_INFO(LogCategory::Game, "Remaining ships placed automatically.");
+    model.fleet.SetCurrentShipIndex((int)model.fleet.GetShips().size());
+    StartBattle();
+}
+
 void BattleshipGame::HandleShipPlacementKeyboard(SDL_Keycode key) {
     switch (key) {
+        case SDLK_A:
+            // Place all remaining ships at random
+            AutoPlaceRemainingShips();
+            break;
+        case SDLK_T: {
+            // Cycle the AI's targeting strategy for the coming battle
+            TargetingStrategy next = TargetingStrategy::RandomAdjacent;
+            switch (aiPlayer->GetTargetingStrategy()) {
+                case TargetingStrategy::RandomAdjacent: next = TargetingStrategy::ProbabilityDensity; break;
+                case TargetingStrategy::ProbabilityDensity: next = TargetingStrategy::MonteCarlo; break;
+                case TargetingStrategy::MonteCarlo: next = TargetingStrategy::RandomAdjacent; break;
+            }
+            aiPlayer->SetTargetingStrategy(next);
+            LOG_INFO(LogCategory::Game, "AI targeting: {}", GetTargetingStrategyName(next));
+            needsRedraw = true;
+            break;
+        }
         case SDLK_R:
         case SDLK_SPACE:
             // Rotate ship
-            shipManager->ToggleOrientation();
-            std::cout << "Ship orientation: " << (shipManager->IsHorizontal() ? "Horizontal" : "Vertical") << std::endl;
+            model.fleet.ToggleOrientation();
+            LOG_INFO(LogCategory::Game, "Ship orientation: {}", model.fleet.IsHorizontal() ? "Horizontal" : "Vertical");
             UpdateShipPreviewAtCurrentPosition();
             break;
         case SDLK_1:
@@ -225,11 +464,11 @@ void BattleshipGame::HandleShipPlacementKeyboard(SDL_Keycode key) {
         case SDLK_0:
             // Select ship by number
             int shipIndex = key - SDLK_1;
-            const auto& ships = shipManager->GetShips();
+            const auto& ships = model.fleet.GetShips();
             if (shipIndex < ships.size() && !ships[shipIndex].placed) {
-                shipManager->SetCurrentShipIndex(shipIndex);
-                std::cout << "Selected " << ships[shipIndex].name 
-                         << " (" << ships[shipIndex].size << " cells)" << std::endl;
+                model.fleet.SetCurrentShipIndex(shipIndex);
+                LOG_INFO(LogCategory::Game, "Selected {} ({} cells)", ShipManager::GetShipName(shipIndex),
+                         ships[shipIndex].size);
                 UpdateShipPreviewAtCurrentPosition();
             }
             break;
@@ -238,7 +477,7 @@ void BattleshipGame::HandleShipPlacementKeyboard(SDL_Keycode key) {
 
 void BattleshipGame::HandleGridClick(int mouseX, int mouseY) {
     // Only process clicks if it's player's turn and game hasn't ended
-    if (!gameState->IsPlayerTurn() || gameState->IsGameEnded()) return;
+    if (replaying || model.match.GetSideToMove() != Side::Player || model.match.IsOver()) return;
     
     // Check if click is in target grid area
     int targetGridX = GRID_MARGIN * 2 + GRID_SIZE * CELL_SIZE + GRID_SPACING;
@@ -250,40 +489,47 @@ void BattleshipGame::HandleGridClick(int mouseX, int mouseY) {
         GridPosition pos = ScreenToGrid(mouseX, mouseY, false);
         
         // Only allow firing at cells that haven't been targeted yet
-        if (targetGrid->GetCell(pos.x, pos.y) == CellState::Empty) {
+        if (model.targetGrid.GetCell(pos.x, pos.y) == CellState::Empty) {
             ProcessPlayerShot(pos);
         }
     }
 }
 
 void BattleshipGame::UpdateShipPreview(int mouseX, int mouseY) {
-    // Clear previous preview
-    playerGrid->ClearPreview();
-    
     // Check if mouse is over player grid
     int playerGridX = GRID_MARGIN;
     int playerGridY = GRID_MARGIN + 30;
     
-    if (mouseX >= playerGridX && mouseX < playerGridX + GRID_SIZE * CELL_SIZE &&
-        mouseY >= playerGridY && mouseY < playerGridY + GRID_SIZE * CELL_SIZE &&
-        !shipManager->AllShipsPlaced()) {
-        
-        mouseGridPos = ScreenToGrid(mouseX, mouseY, true);
-        const auto& ships = shipManager->GetShips();
-        int currentShipIndex = shipManager->GetCurrentShipIndex();
+    bool overGrid = mouseX >= playerGridX && mouseX < playerGridX + GRID_SIZE * CELL_SIZE &&
+                    mouseY >= playerGridY && mouseY < playerGridY + GRID_SIZE * CELL_SIZE &&
+                    !model.fleet.AllShipsPlaced();
+    GridPosition hovered = overGrid ? ScreenToGrid(mouseX, mouseY, true) : GridPosition(-1, -1);
+    
+    // Motion within the same cell leaves the preview unchanged
+    if (hovered == previewGridPos) return;
+    previewGridPos = hovered;
+    needsRedraw = true;
+    
+    // Clear previous preview
+    PlayerGrid().ClearPreview();
+    
+    if (overGrid) {
+        mouseGridPos = hovered;
+        const auto& ships = model.fleet.GetShips();
+        int currentShipIndex = model.fleet.GetCurrentShipIndex();
         
         // Check if placement is valid
-        bool isValid = shipManager->IsValidPlacement(*playerGrid, mouseGridPos.x, mouseGridPos.y, 
-                                                   ships[currentShipIndex].size, shipManager->IsHorizontal());
+        bool isValid = model.fleet.IsValidPlacement(PlayerGrid(), mouseGridPos.x, mouseGridPos.y, 
+                                                   ships[currentShipIndex].size, model.fleet.IsHorizontal());
         
         // Draw preview
         for (int i = 0; i < ships[currentShipIndex].size; ++i) {
-            int x = shipManager->IsHorizontal() ? mouseGridPos.x + i : mouseGridPos.x;
-            int y = shipManager->IsHorizontal() ? mouseGridPos.y : mouseGridPos.y + i;
+            int x = model.fleet.IsHorizontal() ? mouseGridPos.x + i : mouseGridPos.x;
+            int y = model.fleet.IsHorizontal() ? mouseGridPos.y : mouseGridPos.y + i;
             
-            if (playerGrid->IsValidPosition(x, y)) {
-                if (playerGrid->GetCell(x, y) == CellState::Empty) {
-                    playerGrid->SetCell(x, y, isValid ? CellState::Preview : CellState::InvalidPreview);
+            if (PlayerGrid().IsValidPosition(x, y)) {
+                if (PlayerGrid().GetCell(x, y) == CellState::Empty) {
+                    PlayerGrid().SetCell(x, y, isValid ? CellState::Preview : CellState::InvalidPreview);
                 }
             }
         }
@@ -292,32 +538,35 @@ void BattleshipGame::UpdateShipPreview(int mouseX, int mouseY) {
 
 void BattleshipGame::UpdateShipPreviewAtCurrentPosition() {
     // Clear previous preview
-    playerGrid->ClearPreview();
+    PlayerGrid().ClearPreview();
+    previewGridPos = GridPosition(-1, -1);
+    needsRedraw = true;
     
     // Check if we have a valid current position and are in ship placement mode
-    if (!shipManager->AllShipsPlaced()) {
+    if (!model.fleet.AllShipsPlaced()) {
         // If we don't have a valid mouse position yet, use a default position (center of grid)
         if (mouseGridPos.x < 0 || mouseGridPos.x >= GRID_SIZE || 
             mouseGridPos.y < 0 || mouseGridPos.y >= GRID_SIZE) {
             mouseGridPos.x = GRID_SIZE / 2;
             mouseGridPos.y = GRID_SIZE / 2;
         }
+        previewGridPos = mouseGridPos;
         
-        const auto& ships = shipManager->GetShips();
-        int currentShipIndex = shipManager->GetCurrentShipIndex();
+        const auto& ships = model.fleet.GetShips();
+        int currentShipIndex = model.fleet.GetCurrentShipIndex();
         
         // Check if placement is valid
-        bool isValid = shipManager->IsValidPlacement(*playerGrid, mouseGridPos.x, mouseGridPos.y, 
-                                                   ships[currentShipIndex].size, shipManager->IsHorizontal());
+        bool isValid = model.fleet.IsValidPlacement(PlayerGrid(), mouseGridPos.x, mouseGridPos.y, 
+                                                   ships[currentShipIndex].size, model.fleet.IsHorizontal());
         
         // Draw preview at current position
         for (int i = 0; i < ships[currentShipIndex].size; ++i) {
-            int x = shipManager->IsHorizontal() ? mouseGridPos.x + i : mouseGridPos.x;
-            int y = shipManager->IsHorizontal() ? mouseGridPos.y : mouseGridPos.y + i;
+            int x = model.fleet.IsHorizontal() ? mouseGridPos.x + i : mouseGridPos.x;
+            int y = model.fleet.IsHorizontal() ? mouseGridPos.y : mouseGridPos.y + i;
             
-            if (playerGrid->IsValidPosition(x, y)) {
-                if (playerGrid->GetCell(x, y) == CellState::Empty) {
-                    playerGrid->SetCell(x, y, isValid ? CellState::Preview : CellState::InvalidPreview);
+            if (PlayerGrid().IsValidPosition(x, y)) {
+                if (PlayerGrid().GetCell(x, y) == CellState::Empty) {
+                    PlayerGrid().SetCell(x, y, isValid ? CellState::Preview : CellState::InvalidPreview);
                 }
             }
         }
@@ -325,113 +574,175 @@ void BattleshipGame::UpdateShipPreviewAtCurrentPosition() {
 }
 
 void BattleshipGame::ProcessPlayerShot(GridPosition target) {
-    // Check if hit or miss
-    if (aiGrid->GetCell(target.x, target.y) == CellState::Ship) {
-        // Update both grids
-        aiGrid->SetCell(target.x, target.y, CellState::Hit);
-        targetGrid->SetCell(target.x, target.y, CellState::Hit);
-        std::cout << "HIT at " << (char)('A' + target.x) << (target.y + 1) << "!" << std::endl;
+    ShotOutcome outcome;
+    if (!model.match.Fire(target.x, target.y, outcome)) return;
+    recorder.RecordShot(Side::Player, target.x, target.y, outcome);
+    
+    if (outcome.result != ShotResult::Miss) {
+        model.targetGrid.SetCell(target.x, target.y, CellState::Hit);
+        LOG_INFO(LogCategory::Game, "HIT at {}{}!", (char)('A' + target.x), target.y + 1);
         
         // Check if ship is sunk
-        if (shipManager->IsShipSunk(*aiGrid, target)) {
-            std::cout << "You sunk an enemy ship!" << std::endl;
+        if (outcome.result == ShotResult::Sunk) {
+            LOG_INFO(LogCategory::Game, "You sunk an enemy ship!");
         }
     } else {
-        targetGrid->SetCell(target.x, target.y, CellState::Miss);
-        std::cout << "MISS at " << (char)('A' + target.x) << (target.y + 1) << std::endl;
+        model.targetGrid.SetCell(target.x, target.y, CellState::Miss);
+        LOG_INFO(LogCategory::Game, "MISS at {}{}", (char)('A' + target.x), target.y + 1);
     }
     
-    // Switch to AI turn
-    gameState->SetPlayerTurn(false);
-    std::cout << "AI's turn..." << std::endl;
+    needsRedraw = true;
+    
+    // AI turn is delayed a little to make AI moves visible
+    if (!outcome.matchOver) {
+        aiTurnDeadline = SDL_GetTicks() + AI_TURN_DELAY_MS;
+        if (!replaying) {
+            RequestAIMove();
+        }
+        LOG_INFO(LogCategory::Game, "AI's turn...");
+    }
     
     // Check victory condition
     CheckVictoryCondition();
 }
 
 void BattleshipGame::ProcessAIShot(GridPosition target) {
-    std::cout << "AI fires at " << (char)('A' + target.x) << (target.y + 1) << std::endl;
+    LOG_INFO(LogCategory::Game, "AI fires at {}{}", (char)('A' + target.x), target.y + 1);
+    
+    ShotOutcome outcome;
+    if (!model.match.Fire(target.x, target.y, outcome)) {
+        LOG_ERROR(LogCategory::Game, "AI picked an invalid target!");
+        return;
+    }
+    recorder.RecordShot(Side::AI, target.x, target.y, outcome);
     
-    // Check if hit or miss
-    if (playerGrid->GetCell(target.x, target.y) == CellState::Ship) {
-        playerGrid->SetCell(target.x, target.y, CellState::Hit);
-        std::cout << "AI HIT your ship!" << std::endl;
+    if (outcome.result != ShotResult::Miss) {
+        LOG_INFO(LogCategory::Game, "AI HIT your ship!");
         
-        // Remember this hit for next turn
-        aiPlayer->SetLastHit(target);
+        // Remember this hit for next turn; the thinker may still own the AI
+        aiFeedbackHit = target;
         
         // Check if ship is sunk
-        if (shipManager->IsShipSunk(*playerGrid, target)) {
-            std::cout << "AI sunk one of your ships!" << std::endl;
-            aiPlayer->ClearLastHit();
-            aiPlayer->ClearTargetQueue();
+        if (outcome.result == ShotResult::Sunk) {
+            LOG_INFO(LogCategory::Game, "AI sunk one of your ships!");
+            aiFeedbackSunk = PlayerGrid().GetShipCells(outcome.shipId);
         }
     } else {
-        playerGrid->SetCell(target.x, target.y, CellState::Miss);
-        std::cout << "AI missed." << std::endl;
+        LOG_INFO(LogCategory::Game, "AI missed.");
     }
+    needsRedraw = true;
     
-    // Switch to player turn
-    gameState->SetPlayerTurn(true);
-    std::cout << "Your turn!" << std::endl;
+    if (!outcome.matchOver) {
+        LOG_INFO(LogCategory::Game, "Your turn!");
+    }
     
     // Check victory condition
     CheckVictoryCondition();
 }
 
+// The search starts at once and runs while the turn delay keeps the player's shot on screen
+void BattleshipGame::RequestAIMove() {
+    aiTurnStart = SDL_GetTicks();
+    aiThinkDeadline = aiTurnStart + AI_THINK_BUDGET_MS;
+    thinkingPhase = 0;
+    aiThinker->Post(PlayerGrid().GetHitMask(), PlayerGrid().GetMissMask(), aiFeedbackHit, aiFeedbackSunk);
+    aiFeedbackHit = GridPosition(-1, -1);
+    aiFeedbackSunk = BitBoard();
+}
+
 void BattleshipGame::ProcessAITurn() {
-    aiTurnDelay++;
+    Uint64 now = SDL_GetTicks();
+    int phase = (int)((now - aiTurnStart) / THINKING_DOT_MS % 4);
+    if (phase != thinkingPhase) {
+        thinkingPhase = phase;
+        needsRedraw = true;
+    }
+    
+    // Wait until the AI turn delay has elapsed
+    if (now < aiTurnDeadline) return;
     
-    // Add a small delay to make AI moves visible
-    if (aiTurnDelay < 30) return; // ~0.5 second delay at 60 FPS
-    aiTurnDelay = 0;
+    GridPosition target;
+    if (aiThinker->GetMove(target) != AIThinker::MoveKind::Final) {
+        // Out of time: the search stops at its next check and plays its best so far
+        if (now >= aiThinkDeadline) aiThinker->Hurry();
+        return;
+    }
+    if (now >= aiThinkDeadline) {
+        LOG_INFO(LogCategory::AI, "AI out of time after {} ms, played its best move so far", now - aiTurnStart);
+    }
     
-    GridPosition target = aiPlayer->GetTarget(*playerGrid);
+    ProfileScope scope(profiler, ProfilePhase::AITurn);
     ProcessAIShot(target);
 }
 
+void BattleshipGame::ProcessReplayShot() {
+    if (model.match.IsOver() || replayShotIndex >= replayGame.GetShotCount()) return;
+    if (SDL_GetTicks() < replayDeadline) return;
+    
+    RecordedShot shot = replayGame.GetShot(replayShotIndex++);
+    if (shot.shooter != model.match.GetSideToMove()) {
+        LOG_ERROR(LogCategory::Game, "Replay shot {} is out of turn, stopping", replayShotIndex - 1);
+        replayShotIndex = replayGame.GetShotCount();
+        return;
+    }
+    if (shot.shooter == Side::Player) {
+        ProcessPlayerShot(GridPosition(shot.x, shot.y));
+    } else {
+        ProcessAIShot(GridPosition(shot.x, shot.y));
+    }
+    if (replayShotIndex == replayGame.GetShotCount() && !model.match.IsOver()) {
+        LOG_INFO(LogCategory::Game, "End of replay, the game was abandoned here.");
+    }
+    replayDeadline = SDL_GetTicks() + AI_TURN_DELAY_MS;
+}
+
 void BattleshipGame::CheckVictoryCondition() {
-    gameState->SetPlayerShipsRemaining(playerGrid->CountRemainingShips());
-    gameState->SetAIShipsRemaining(aiGrid->CountRemainingShips());
-    
-    std::cout << "Ships remaining - Player: " << gameState->GetPlayerShipsRemaining() 
-              << ", AI: " << gameState->GetAIShipsRemaining() << std::endl;
-    
-    if (gameState->GetPlayerShipsRemaining() == 0) {
-        gameState->SetVictoryMessage("GAME OVER - AI WINS!");
-        gameState->SetGameEnded(true);
-        gameState->SetState(GameStateType::GameOver);
-        std::cout << "AI wins! All your ships have been sunk." << std::endl;
-        std::cout << "Press SPACE to restart." << std::endl;
-    } else if (gameState->GetAIShipsRemaining() == 0) {
-        gameState->SetVictoryMessage("VICTORY - YOU WIN!");
-        gameState->SetGameEnded(true);
-        gameState->SetState(GameStateType::GameOver);
-        std::cout << "You win! All enemy ships have been sunk." << std::endl;
-        std::cout << "Press SPACE to restart." << std::endl;
+    // Counters are kept up to date per shot; debug builds verify them against a full recount
+    assert(model.match.GetCellsRemaining(Side::Player) == PlayerGrid().CountRemainingShips());
+    assert(model.match.GetCellsRemaining(Side::AI) == AIGrid().CountRemainingShips());
+    
+    LOG_INFO(LogCategory::Game, "Ships remaining - Player: {}, AI: {}", model.match.GetShipsRemaining(Side::Player),
+             model.match.GetShipsRemaining(Side::AI));
+    
+    if (!model.match.IsOver()) return;
+    recorder.EndGame(model.match.GetWinner());
+    
+    if (model.match.GetWinner() == Side::AI) {
+        model.match.GetGameState().SetVictoryMessage(VictoryMessage::AIWins);
+        LOG_INFO(LogCategory::Game, "AI wins! All your ships have been sunk.");
+    } else {
+        model.match.GetGameState().SetVictoryMessage(VictoryMessage::PlayerWins);
+        LOG_INFO(LogCategory::Game, "You win! All enemy ships have been sunk.");
     }
+    LOG_INFO(LogCategory::Game, "Press SPACE to restart.");
 }
 
 void BattleshipGame::RestartGame() {
-    std::cout << "RestartGame function called!" << std::endl;
-    
-    // Reset all components
-    gameState->Reset();
-    playerGrid->Reset();
-    targetGrid->Reset();
-    aiGrid->Reset();
-    shipManager->Reset();
+    LOG_INFO(LogCategory::Game, "RestartGame function called!");
+    
+    // Leaving a replay goes back to normal play
+    replaying = false;
+    replayFile.Close();
+    
+    // Reset all components; a search still running owns the AI until it ends
+    model.Reset();
+    aiThinker->WaitUntilIdle();
     aiPlayer->Reset();
+    aiFeedbackHit = GridPosition(-1, -1);
+    aiFeedbackSunk = BitBoard();
+    PrepareAIFleet();
     
     // Reset UI state
     mouseGridPos = GridPosition(-1, -1);
     playAgainButtonHovered = false;
-    aiTurnDelay = 0;
+    previewGridPos = GridPosition(-1, -1);
+    aiTurnDeadline = 0;
+    needsRedraw = true;
     
     // Show initial preview
     UpdateShipPreviewAtCurrentPosition();
     
-    std::cout << "Game restarted! Place your ships." << std::endl;
+    LOG_INFO(LogCategory::Game, "Game restarted! Place your ships.");
 }
 
 GridPosition BattleshipGame::ScreenToGrid(int mouseX, int mouseY, bool isPlayerGrid) {
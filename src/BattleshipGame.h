@@ -1,10 +1,15 @@
 #pragma once
 #include <SDL3/SDL.h>
 #include <memory>
-#include "GameState.h"
-#include "Grid.h"
-#include "Ship.h"
+#include <random>
+#include <string>
+#include "GameModel.h"
 #include "AIPlayer.h"
+#include "AIThinker.h"
+#include "FrameProfiler.h"
+#include "GameIndex.h"
+#include "GameRecord.h"
+#include "MappedFile.h"
 #include "Renderer.h"
 
 class BattleshipGame {
@@ -15,15 +20,17 @@ public:
     bool Initialize();
     void Run();
     void Cleanup();
+    
+    // Records every game played from now on to a game-record file
+    bool StartRecording(const std::string& path);
+    // Shows a game of a record file from the given shot on, one shot per AI turn delay
+    bool LoadReplay(const std::string& path, int gameIndex, int shotIndex = 0);
 
 private:
-    // Core components
-    std::unique_ptr<GameState> gameState;
-    std::unique_ptr<Grid> playerGrid;
-    std::unique_ptr<Grid> targetGrid;
-    std::unique_ptr<Grid> aiGrid;
-    std::unique_ptr<ShipManager> shipManager;
+    // Game state in one flat value; the AI keeps its search state to itself
+    GameModel model;
     std::unique_ptr<AIPlayer> aiPlayer;
+    std::unique_ptr<AIThinker> aiThinker; // Decides on its own thread; after aiPlayer so it stops first
     std::unique_ptr<Renderer> renderer;
     
     // SDL components
@@ -32,22 +39,42 @@ private:
     
     // Game loop
     bool isRunning;
+    bool needsRedraw;
     
     // UI state
     GridPosition mouseGridPos;
+    GridPosition previewGridPos;
     SDL_FRect playAgainButton;
     bool playAgainButtonHovered;
     
+    // Frame phase timings: overlay on F3, Chrome trace on F4
+    FrameProfiler profiler;
+    
+    // Game recording and replay
+    GameRecordWriter recorder;
+    uint64_t gameSeed;
+    MappedFile replayFile;
+    GameRecordView replayGame; // Points into replayFile
+    int replayShotIndex;
+    Uint64 replayDeadline;
+    bool replaying;
+    
     // Game flow methods
     void HandleEvents();
     void Update();
     void Render();
+    void RenderProfilerOverlay();
+    void ToggleTrace();
     void RestartGame();
+    Sint32 GetEventWaitTimeout() const;
     
     // Event handlers
     void HandleShipPlacementClick(int mouseX, int mouseY);
     void HandleShipPlacementKeyboard(SDL_Keycode key);
     void HandleGridClick(int mouseX, int mouseY);
+    void AutoPlaceRemainingShips();
+    void PrepareAIFleet();
+    void StartBattle();
     
     // Ship placement
     void UpdateShipPreview(int mouseX, int mouseY);
@@ -56,18 +83,39 @@ private:
     // Combat
     void ProcessPlayerShot(GridPosition target);
     void ProcessAIShot(GridPosition target);
+    void RequestAIMove();
     void ProcessAITurn();
+    bool IsAITurnPending() const;
+    void ProcessReplayShot();
     
     // Game logic
     void CheckVictoryCondition();
+    Grid& PlayerGrid() { return model.match.GetGrid(Side::Player); }
+    Grid& AIGrid() { return model.match.GetGrid(Side::AI); }
     GridPosition ScreenToGrid(int mouseX, int mouseY, bool isPlayerGrid);
     
+    // Random source for player auto-placement
+    std::mt19937 randomGenerator;
+    
     // AI turn timing
-    int aiTurnDelay;
+    Uint64 aiTurnStart;
+    Uint64 aiTurnDeadline;  // The move shows no earlier than this
+    Uint64 aiThinkDeadline; // Past this the best move so far is played
+    int thinkingPhase;      // Dots of the thinking indicator
+    
+    // What the AI's last shot revealed, passed on with the next request
+    GridPosition aiFeedbackHit;
+    BitBoard aiFeedbackSunk;
     
     // Constants
     static constexpr int WINDOW_WIDTH = 800;
     static constexpr int WINDOW_HEIGHT = 600;
     static constexpr int GRID_MARGIN = 50;
     static constexpr int GRID_SPACING = 50;
+    static constexpr int CELL_SIZE = 30;
+    static constexpr Uint64 AI_TURN_DELAY_MS = 500;
+    static constexpr Uint64 AI_THINK_BUDGET_MS = 2000;
+    static constexpr Uint64 THINKING_DOT_MS = 250;
+    static constexpr Sint32 FRAME_MS = 16;
+    static constexpr const char* TRACE_FILE = "battleship_trace.json";
 };
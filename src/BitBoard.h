@@ -0,0 +1,115 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include "GameState.h"
+
+static_assert(GRID_SIZE * GRID_SIZE <= 128, "Board does not fit in a 128-bit mask");
+
+// 128-bit set of board cells. Cell (x, y) is bit y * GRID_SIZE + x.
+struct BitBoard {
+    uint64_t lo;
+    uint64_t hi;
+    
+    constexpr BitBoard() : lo(0), hi(0) {}
+    constexpr BitBoard(uint64_t low, uint64_t high) : lo(low), hi(high) {}
+    
+    static constexpr int CellIndex(int x, int y) { return y * GRID_SIZE + x; }
+    
+    static constexpr BitBoard Cell(int index) {
+        return index < 64 ? BitBoard(uint64_t(1) << index, 0) : BitBoard(0, uint64_t(1) << (index - 64));
+    }
+    static constexpr BitBoard Cell(int x, int y) { return Cell(CellIndex(x, y)); }
+    
+    static constexpr BitBoard Full() {
+        BitBoard board;
+        for (int i = 0; i < GRID_SIZE * GRID_SIZE; ++i) board.Set(i);
+        return board;
+    }
+    
+    static constexpr BitBoard Column(int x) {
+        BitBoard board;
+        for (int y = 0; y < GRID_SIZE; ++y) board.Set(CellIndex(x, y));
+        return board;
+    }
+    
+    constexpr bool Test(int index) const {
+        return index < 64 ? (lo >> index) & 1 : (hi >> (index - 64)) & 1;
+    }
+    constexpr bool Test(int x, int y) const { return Test(CellIndex(x, y)); }
+    
+    constexpr void Set(int index) { *this |= Cell(index); }
+    constexpr void Reset(int index) { *this &= ~Cell(index); }
+    
+    constexpr bool Any() const { return (lo | hi) != 0; }
+    constexpr bool None() const { return (lo | hi) == 0; }
+    constexpr int Count() const { return std::popcount(lo) + std::popcount(hi); }
+    
+    // Index of the lowest set bit; the board must not be empty
+    constexpr int LowestIndex() const {
+        return lo ? std::countr_zero(lo) : 64 + std::countr_zero(hi);
+    }
+    
+    // Removes and returns the lowest set bit, for iterating over cells
+    constexpr int PopLowest() {
+        int index = LowestIndex();
+        if (lo) lo &= lo - 1; else hi &= hi - 1;
+        return index;
+    }
+    
+    // Index of the n-th set bit (0-based); n must be below Count()
+    constexpr int NthIndex(int n) const {
+        uint64_t word = lo;
+        int base = 0;
+        int lowCount = std::popcount(lo);
+        if (n >= lowCount) {
+            n -= lowCount;
+            word = hi;
+            base = 64;
+        }
+        for (; n > 0; --n) {
+            word &= word - 1;
+        }
+        return base + std::countr_zero(word);
+    }
+    
+    constexpr BitBoard operator&(const BitBoard& other) const { return {lo & other.lo, hi & other.hi}; }
+    constexpr BitBoard operator|(const BitBoard& other) const { return {lo | other.lo, hi | other.hi}; }
+    constexpr BitBoard operator^(const BitBoard& other) const { return {lo ^ other.lo, hi ^ other.hi}; }
+    constexpr BitBoard operator~() const { return {~lo, ~hi}; }
+    constexpr BitBoard& operator&=(const BitBoard& other) { lo &= other.lo; hi &= other.hi; return *this; }
+    constexpr BitBoard& operator|=(const BitBoard& other) { lo |= other.lo; hi |= other.hi; return *this; }
+    constexpr bool operator==(const BitBoard& other) const { return lo == other.lo && hi == other.hi; }
+    
+    constexpr BitBoard operator<<(int n) const {
+        if (n == 0) return *this;
+        if (n >= 64) return {0, lo << (n - 64)};
+        return {lo << n, (hi << n) | (lo >> (64 - n))};
+    }
+    constexpr BitBoard operator>>(int n) const {
+        if (n == 0) return *this;
+        if (n >= 64) return {hi >> (n - 64), 0};
+        return {(lo >> n) | (hi << (64 - n)), hi >> n};
+    }
+    
+    // One-cell moves that drop whatever falls off the board edge
+    constexpr BitBoard East() const;
+    constexpr BitBoard West() const;
+    constexpr BitBoard North() const { return *this >> GRID_SIZE; }
+    constexpr BitBoard South() const;
+    
+    // The cells plus their 8-neighbourhood
+    constexpr BitBoard Dilate() const;
+};
+
+inline constexpr BitBoard BOARD_MASK = BitBoard::Full();
+inline constexpr BitBoard NOT_FIRST_COLUMN = BOARD_MASK & ~BitBoard::Column(0);
+inline constexpr BitBoard NOT_LAST_COLUMN = BOARD_MASK & ~BitBoard::Column(GRID_SIZE - 1);
+
+constexpr BitBoard BitBoard::East() const { return (*this & NOT_LAST_COLUMN) << 1; }
+constexpr BitBoard BitBoard::West() const { return (*this & NOT_FIRST_COLUMN) >> 1; }
+constexpr BitBoard BitBoard::South() const { return (*this << GRID_SIZE) & BOARD_MASK; }
+
+constexpr BitBoard BitBoard::Dilate() const {
+    BitBoard row = *this | East() | West();
+    return row | row.North() | row.South();
+}
@@ -0,0 +1,74 @@
+#include "DensityTargeting.h"
+
+namespace {
+
+// Adds weight to every cell of each consistent placement. With requireHit set,
+// placements that cover no open hit are skipped. Returns the number counted.
+int AccumulatePlacements(const TargetingView& view, const BitBoard& freeCells, bool requireHit,
+                         std::array<int, GRID_SIZE * GRID_SIZE>& density) {
+    int counted = 0;
+    for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+        int weight = view.remainingShips[size];
+        if (weight <= 0) continue;
+        
+        AnchorSet anchors = ComputeAnchors(freeCells, size);
+        for (int orientation = 0; orientation < 2; ++orientation) {
+            BitBoard remaining = orientation == 0 ? anchors.horizontal : anchors.vertical;
+            int step = orientation == 0 ? 1 : GRID_SIZE;
+            while (remaining.Any()) {
+                int anchor = remaining.PopLowest();
+                const PlacementMasks& masks = PLACEMENT_TABLE[size][orientation][anchor];
+                if ((masks.halo & ~masks.footprint & view.openHits).Any()) continue;
+                if (requireHit && (masks.footprint & view.openHits).None()) continue;
+                
+                for (int i = 0, cell = anchor; i < size; ++i, cell += step) {
+                    density[cell] += weight;
+                }
+                counted++;
+            }
+        }
+    }
+    return counted;
+}
+
+} // namespace
+
+void ComputePlacementDensity(const TargetingView& view, std::array<int, GRID_SIZE * GRID_SIZE>& density) {
+    density.fill(0);
+    // Misses can't hold a ship and nothing can touch a sunk one
+    BitBoard freeCells = BOARD_MASK & ~(view.misses | view.sunkCells.Dilate());
+    
+    if (view.openHits.Any() && AccumulatePlacements(view, freeCells, true, density) > 0) {
+        return;
+    }
+    // Hunting, or the hits admit no placement (e.g. the fleet description is off)
+    density.fill(0);
+    TargetingView hunt = view;
+    hunt.openHits = BitBoard();
+    AccumulatePlacements(hunt, freeCells, false, density);
+}
+
+int ChooseDensityTarget(const TargetingView& view, std::mt19937& rng) {
+    std::array<int, GRID_SIZE * GRID_SIZE> density;
+    ComputePlacementDensity(view, density);
+    
+    BitBoard unshot = BOARD_MASK & ~(view.openHits | view.misses | view.sunkCells);
+    if (unshot.None()) {
+        return -1;
+    }
+    
+    int best = -1;
+    BitBoard ties;
+    for (BitBoard cells = unshot; cells.Any();) {
+        int cell = cells.PopLowest();
+        if (density[cell] > best) {
+            best = density[cell];
+            ties = BitBoard::Cell(cell);
+        } else if (density[cell] == best) {
+            ties.Set(cell);
+        }
+    }
+    
+    int pick = std::uniform_int_distribution<int>(0, ties.Count() - 1)(rng);
+    return ties.NthIndex(pick);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <array>
+#include <random>
+#include "BitBoard.h"
+#include "PlacementTable.h"
+
+// What the shooter knows about the opponent's board
+struct TargetingView {
+    BitBoard openHits;   // Hits on ships that are still afloat
+    BitBoard misses;
+    BitBoard sunkCells;  // Cells of ships reported sunk
+    std::array<int, MAX_SHIP_SIZE + 1> remainingShips{}; // Afloat ships per size
+};
+
+// Lets another thread follow a slow targeting search and cut it short. The
+// search reports its current best cell whenever it has a better estimate, and
+// once ShouldStop returns true it returns its best so far as its choice.
+// Both are called on the searching thread.
+class SearchObserver {
+public:
+    virtual void OnBestSoFar(int cell) = 0;
+    virtual bool ShouldStop() = 0;
+
+protected:
+    ~SearchObserver() = default;
+};
+
+// Counts, per cell, the placements of every afloat ship that are still consistent
+// with the view. A placement may not cover a miss or touch a sunk ship, and may not
+// touch an open hit it doesn't cover (that hit would belong to a touching ship).
+// While open hits exist only placements covering one of them are counted.
+void ComputePlacementDensity(const TargetingView& view, std::array<int, GRID_SIZE * GRID_SIZE>& density);
+
+// Unshot cell with the highest density, ties broken at random; -1 if every cell was shot
+int ChooseDensityTarget(const TargetingView& view, std::mt19937& rng);
@@ -0,0 +1,341 @@
+#include "EndgameSolver.h"
+#include "PlacementTable.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <limits>
+
+namespace {
+
+// Cell states a shot board can hold; unshot cells contribute nothing to the key
+enum ZobristState { ZOBRIST_MISS, ZOBRIST_HIT, ZOBRIST_SUNK, ZOBRIST_STATES };
+
+using ZobristTable = std::array<std::array<uint64_t, ZOBRIST_STATES>, GRID_SIZE * GRID_SIZE>;
+
+constexpr ZobristTable BuildZobristTable() {
+    ZobristTable keys{};
+    uint64_t state = 0x5EED5EED5EED5EEDull;
+    for (auto& cellKeys : keys) {
+        for (uint64_t& key : cellKeys) {
+            // splitmix64
+            state += 0x9E3779B97F4A7C15ull;
+            uint64_t z = state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            key = z ^ (z >> 31);
+        }
+    }
+    return keys;
+}
+
+constexpr ZobristTable ZOBRIST_KEYS = BuildZobristTable();
+
+struct EnumerationContext {
+    const TargetingView& view;
+    std::array<int, MAX_FLEET_SIZE> sizes;
+    int shipCount;
+    std::array<BitBoard, MAX_FLEET_SIZE> ships;
+    uint64_t visited;
+    uint64_t limit;
+    int maxLayouts;
+    bool overflow;
+};
+
+// Places ship `ship` and the rest after it. Equal-sized ships take increasing
+// table slots so swapping them doesn't produce the same layout twice.
+template <typename Emit>
+void EnumerateFrom(EnumerationContext& context, int ship, int minSlot, const BitBoard& blocked,
+                   const BitBoard& cells, Emit& emit) {
+    if (context.overflow) return;
+    if (++context.visited > context.limit) {
+        context.overflow = true;
+        return;
+    }
+    if (ship == context.shipCount) {
+        if ((context.view.openHits & ~cells).None()) {
+            emit(cells, context.ships);
+        }
+        return;
+    }
+
+    int size = context.sizes[ship];
+    AnchorSet anchors = ComputeAnchors(BOARD_MASK & ~blocked, size);
+    bool nextIsSame = ship + 1 < context.shipCount && context.sizes[ship + 1] == size;
+    for (int orientation = 0; orientation < 2; ++orientation) {
+        BitBoard remaining = orientation == 0 ? anchors.horizontal : anchors.vertical;
+        while (remaining.Any()) {
+            int anchor = remaining.PopLowest();
+            int slot = orientation * GRID_SIZE * GRID_SIZE + anchor;
+            if (slot < minSlot) continue;
+
+            const PlacementMasks& masks = PLACEMENT_TABLE[size][orientation][anchor];
+            // An open hit next to the ship would need a second ship touching it
+            if ((masks.halo & ~masks.footprint & context.view.openHits).Any()) continue;
+
+            context.ships[ship] = masks.footprint;
+            EnumerateFrom(context, ship + 1, nextIsSame ? slot + 1 : 0, blocked | masks.halo,
+                          cells | masks.footprint, emit);
+            if (context.overflow) return;
+        }
+    }
+}
+
+// Cheap upper bound on the layouts EnumerateLayouts can find: the ships of each
+// size take distinct consistent placements, ignoring how ships of different
+// sizes get in each other's way. Stops counting once it passes limit.
+uint64_t BoundLayouts(const TargetingView& view, uint64_t limit) {
+    BitBoard freeCells = BOARD_MASK & ~(view.misses | view.sunkCells.Dilate());
+    uint64_t bound = 1;
+    for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+        int ships = view.remainingShips[size];
+        if (ships <= 0) continue;
+
+        AnchorSet anchors = ComputeAnchors(freeCells, size);
+        int placements = 0;
+        for (int orientation = 0; orientation < 2; ++orientation) {
+            for (BitBoard remaining = orientation == 0 ? anchors.horizontal : anchors.vertical; remaining.Any();) {
+                const PlacementMasks& masks = PLACEMENT_TABLE[size][orientation][remaining.PopLowest()];
+                placements += (masks.halo & ~masks.footprint & view.openHits).None();
+            }
+        }
+        if (ships > placements) {
+            return 0;
+        }
+
+        // C(placements, ships) grows with each factor up to the smaller of ships
+        // and placements - ships, so it can stop as soon as it passes the limit
+        int picks = std::min(ships, placements - ships);
+        uint64_t choices = 1;
+        for (int i = 0; i < picks && choices <= limit; ++i) {
+            choices = choices * (uint64_t)(placements - i) / (uint64_t)(i + 1);
+        }
+        if (choices > limit) {
+            return limit + 1;
+        }
+        bound *= choices;
+        if (bound > limit) {
+            return limit + 1;
+        }
+    }
+    return bound;
+}
+
+} // namespace
+
+// The table is 1 MB, so it is only allocated once a search actually runs
+EndgameSolver::EndgameSolver() {
+}
+
+void EndgameSolver::ClearTable() {
+    std::fill(table.begin(), table.end(), TableEntry{0, 0.0f, -1, false});
+}
+
+bool EndgameSolver::EnumerateLayouts(const TargetingView& view) {
+    layouts.clear();
+    EnumerationContext context{view, {}, 0, {}, 0, ENUMERATION_LIMIT, MAX_LAYOUTS, false};
+    for (int size = MAX_SHIP_SIZE; size >= 1; --size) {
+        for (int i = 0; i < view.remainingShips[size]; ++i) {
+            if (context.shipCount == MAX_FLEET_SIZE) return false;
+            context.sizes[context.shipCount++] = size;
+        }
+    }
+    if (context.shipCount == 0) return false;
+
+    auto emit = [this, &context](const BitBoard& cells, const std::array<BitBoard, MAX_FLEET_SIZE>& ships) {
+        if ((int)layouts.size() == context.maxLayouts) {
+            context.overflow = true;
+            return;
+        }
+        layouts.push_back({cells, ships, context.shipCount});
+    };
+
+    // Misses can't hold a ship and nothing can touch a sunk one
+    BitBoard blocked = view.misses | view.sunkCells.Dilate();
+    EnumerateFrom(context, 0, 0, blocked, BitBoard(), emit);
+    return !context.overflow && !layouts.empty();
+}
+
+bool EndgameSolver::FindBestShot(const TargetingView& view, int& cell, SearchObserver* searchObserver) {
+    auto start = std::chrono::steady_clock::now();
+    lastStats = Stats();
+    // Most positions have far too many layouts, and this tells in microseconds
+    uint64_t bound = BoundLayouts(view, MAX_LAYOUTS);
+    if (bound == 0 || bound > MAX_LAYOUTS || !EnumerateLayouts(view)) {
+        return false;
+    }
+
+    Board root{view.openHits | view.sunkCells, view.misses, view.sunkCells, 0};
+    for (BitBoard cells = root.misses; cells.Any();) {
+        root.key ^= ZOBRIST_KEYS[cells.PopLowest()][ZOBRIST_MISS];
+    }
+    for (BitBoard cells = root.hits; cells.Any();) {
+        int index = cells.PopLowest();
+        root.key ^= ZOBRIST_KEYS[index][root.sunk.Test(index) ? ZOBRIST_SUNK : ZOBRIST_HIT];
+    }
+
+    if (table.empty()) {
+        table.assign((size_t)1 << TABLE_BITS, TableEntry{0, 0.0f, -1, false});
+    }
+    nodes = 0;
+    tableProbes = 0;
+    tableHits = 0;
+    aborted = false;
+    stopped = false;
+    observer = searchObserver;
+    uint64_t candidates = layouts.size() == 64 ? ~0ull : (1ull << layouts.size()) - 1;
+    int bestCell = -1;
+    double expected = Solve(candidates, root, &bestCell);
+
+    lastStats.layouts = (int)layouts.size();
+    lastStats.expectedShots = expected;
+    lastStats.nodes = nodes;
+    lastStats.tableProbes = tableProbes;
+    lastStats.tableHits = tableHits;
+    lastStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    observer = nullptr;
+    if ((aborted && !stopped) || bestCell < 0) {
+        return false;
+    }
+    cell = bestCell;
+    return true;
+}
+
+// Expected shots to sink every afloat ship from this board, averaged over the
+// candidate layouts. Children are always solved exactly, so table entries
+// never hold bounds.
+double EndgameSolver::Solve(uint64_t candidates, const Board& board, int* bestCell) {
+    if (++nodes > NODE_LIMIT) {
+        aborted = true;
+        return 0.0;
+    }
+    if (observer && nodes % STOP_CHECK_INTERVAL == 0 && observer->ShouldStop()) {
+        aborted = stopped = true;
+        return 0.0;
+    }
+
+    BitBoard shot = board.hits | board.misses;
+    int layoutCount = std::popcount(candidates);
+    if (layoutCount == 1 && !bestCell) {
+        // Position fully known: every remaining ship cell costs one shot
+        return (layouts[std::countr_zero(candidates)].cells & ~shot).Count();
+    }
+
+    TableEntry& entry = table[board.key & (((uint64_t)1 << TABLE_BITS) - 1)];
+    tableProbes++;
+    if (entry.used && entry.key == board.key) {
+        tableHits++;
+        if (bestCell) *bestCell = entry.bestCell;
+        return entry.expectedShots;
+    }
+
+    // Per-cell counts of candidates with an unshot ship cell there
+    std::array<int, GRID_SIZE * GRID_SIZE> shipCounts{};
+    BitBoard anyShip;
+    BitBoard everyShip = BOARD_MASK;
+    int remainingTotal = 0;
+    for (uint64_t bits = candidates; bits; bits &= bits - 1) {
+        BitBoard remaining = layouts[std::countr_zero(bits)].cells & ~shot;
+        anyShip |= remaining;
+        everyShip &= remaining;
+        remainingTotal += remaining.Count();
+        while (remaining.Any()) {
+            shipCounts[remaining.PopLowest()]++;
+        }
+    }
+
+    // A cell holding a ship in every layout has to be shot anyway; shooting it
+    // first never hurts and only adds information. Cells with no ship in any
+    // layout teach nothing and are never worth a shot.
+    std::array<int, GRID_SIZE * GRID_SIZE> moves;
+    int moveCount = 0;
+    if (everyShip.Any()) {
+        moves[moveCount++] = everyShip.LowestIndex();
+    } else {
+        for (BitBoard cells = anyShip; cells.Any();) {
+            moves[moveCount++] = cells.PopLowest();
+        }
+        std::sort(moves.begin(), moves.begin() + moveCount,
+                  [&shipCounts](int a, int b) { return shipCounts[a] > shipCounts[b]; });
+    }
+    if (bestCell && observer && moveCount > 0) {
+        observer->OnBestSoFar(moves[0]);
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    int bestMove = -1;
+    for (int m = 0; m < moveCount; ++m) {
+        int cell = moves[m];
+        // Every layout still needs all of its other unshot ship cells, so this
+        // bound only grows along the sorted move list
+        double lowerBound = 1.0 + (double)(remainingTotal - shipCounts[cell]) / layoutCount;
+        if (lowerBound >= best) break;
+
+        // Split the candidates by what the shot would report
+        uint64_t missGroup = 0;
+        uint64_t hitGroup = 0;
+        std::array<uint64_t, MAX_LAYOUTS> sunkGroups;
+        std::array<BitBoard, MAX_LAYOUTS> sunkShips;
+        int sunkGroupCount = 0;
+        BitBoard hitsAfter = board.hits | BitBoard::Cell(cell);
+        for (uint64_t bits = candidates; bits; bits &= bits - 1) {
+            int index = std::countr_zero(bits);
+            const Layout& layout = layouts[index];
+            if (!layout.cells.Test(cell)) {
+                missGroup |= 1ull << index;
+                continue;
+            }
+            if ((layout.cells & ~hitsAfter).None()) {
+                continue; // Last ship cell: the game is over, nothing more to pay
+            }
+
+            int ship = 0;
+            while (!layout.ships[ship].Test(cell)) ship++;
+            if ((layout.ships[ship] & ~hitsAfter).Any()) {
+                hitGroup |= 1ull << index;
+                continue;
+            }
+
+            int group = 0;
+            while (group < sunkGroupCount && !(sunkShips[group] == layout.ships[ship])) group++;
+            if (group == sunkGroupCount) {
+                sunkShips[sunkGroupCount] = layout.ships[ship];
+                sunkGroups[sunkGroupCount++] = 0;
+            }
+            sunkGroups[group] |= 1ull << index;
+        }
+
+        double weightedShots = 0.0;
+        if (missGroup) {
+            Board child{board.hits, board.misses | BitBoard::Cell(cell), board.sunk,
+                        board.key ^ ZOBRIST_KEYS[cell][ZOBRIST_MISS]};
+            weightedShots += std::popcount(missGroup) * Solve(missGroup, child, nullptr);
+        }
+        if (hitGroup) {
+            Board child{hitsAfter, board.misses, board.sunk, board.key ^ ZOBRIST_KEYS[cell][ZOBRIST_HIT]};
+            weightedShots += std::popcount(hitGroup) * Solve(hitGroup, child, nullptr);
+        }
+        for (int group = 0; group < sunkGroupCount; ++group) {
+            Board child{hitsAfter, board.misses, board.sunk | sunkShips[group], board.key};
+            for (BitBoard cells = sunkShips[group]; cells.Any();) {
+                int index = cells.PopLowest();
+                child.key ^= (index == cell ? 0 : ZOBRIST_KEYS[index][ZOBRIST_HIT]) ^ ZOBRIST_KEYS[index][ZOBRIST_SUNK];
+            }
+            weightedShots += std::popcount(sunkGroups[group]) * Solve(sunkGroups[group], child, nullptr);
+        }
+        if (aborted) {
+            if (bestCell) *bestCell = bestMove >= 0 ? bestMove : moves[0];
+            return 0.0;
+        }
+
+        double value = 1.0 + weightedShots / layoutCount;
+        if (value < best) {
+            best = value;
+            bestMove = cell;
+            if (bestCell && observer) observer->OnBestSoFar(cell);
+        }
+    }
+
+    entry = {board.key, (float)best, (int8_t)bestMove, true};
+    if (bestCell) *bestCell = bestMove;
+    return best;
+}
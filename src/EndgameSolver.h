@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+#include "DensityTargeting.h"
+#include "FleetGenerator.h"
+
+// Exact endgame search. Once few layouts of the afloat ships remain consistent
+// with the shots so far, it finds the shot minimising the expected number of
+// shots still needed to sink them all, with every consistent layout equally
+// likely. Positions are hashed with Zobrist keys over the shot board and cached
+// in a fixed-size transposition table, so transpositions are solved once.
+class EndgameSolver {
+public:
+    // The candidate set is a 64-bit mask, one bit per layout; past 32 layouts
+    // the search rarely finishes within NODE_LIMIT
+    static constexpr int MAX_LAYOUTS = 32;
+
+    struct Stats {
+        int layouts = 0;
+        double expectedShots = 0.0;
+        uint64_t nodes = 0;
+        uint64_t tableProbes = 0;
+        uint64_t tableHits = 0;
+        double seconds = 0.0;
+    };
+
+    EndgameSolver();
+
+    // Returns false if more than MAX_LAYOUTS layouts remain or the search ran
+    // out of nodes; otherwise sets cell to the best shot. Layouts are only
+    // enumerated once a per-size placement count bounds them by MAX_LAYOUTS,
+    // so the usual early- and mid-game call costs about a microsecond.
+    // observer, if given, hears of each better root shot as it is solved; if
+    // it stops the search, cell is the best root shot so far (or the one most
+    // layouts share while none is solved yet).
+    bool FindBestShot(const TargetingView& view, int& cell, SearchObserver* observer = nullptr);
+
+    // Positions stay valid across moves of a game; clear between games
+    void ClearTable();
+
+    const Stats& GetLastStats() const { return lastStats; }
+
+private:
+    static constexpr int TABLE_BITS = 16;
+    static constexpr uint64_t NODE_LIMIT = 100'000;
+    static constexpr uint64_t ENUMERATION_LIMIT = 20'000;
+    static constexpr uint64_t STOP_CHECK_INTERVAL = 1024; // Nodes between observer polls
+
+    struct Layout {
+        BitBoard cells;
+        std::array<BitBoard, MAX_FLEET_SIZE> ships;
+        int shipCount;
+    };
+
+    // Shot board of one search node
+    struct Board {
+        BitBoard hits;   // Includes the cells of sunk ships
+        BitBoard misses;
+        BitBoard sunk;
+        uint64_t key;
+    };
+
+    struct TableEntry {
+        uint64_t key;
+        float expectedShots;
+        int8_t bestCell;
+        bool used;
+    };
+
+    std::vector<Layout> layouts;
+    std::vector<TableEntry> table;
+    uint64_t nodes = 0;
+    uint64_t tableProbes = 0;
+    uint64_t tableHits = 0;
+    bool aborted = false;
+    bool stopped = false; // Aborted by the observer rather than NODE_LIMIT
+    SearchObserver* observer = nullptr;
+    Stats lastStats;
+
+    bool EnumerateLayouts(const TargetingView& view);
+    double Solve(uint64_t candidates, const Board& board, int* bestCell);
+};
@@ -0,0 +1,325 @@
+#include "FleetGenerator.h"
+#include "PlacementTable.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct SearchLevel {
+    AnchorSet untried;
+    BitBoard blockedBefore; // Cells no further ship may cover
+    int anchor;
+    bool horizontal;
+};
+
+// Uniform index in [0, count) from one 32-bit draw
+int RandomIndex(std::mt19937& rng, int count) {
+    return (int)(((uint64_t)rng() * (uint64_t)count) >> 32);
+}
+
+// Exactly uniform index in [0, count): Lemire's multiply with the biased
+// low range rejected
+int UniformIndex(std::mt19937& rng, int count) {
+    uint64_t product = (uint64_t)rng() * (uint64_t)count;
+    uint32_t low = (uint32_t)product;
+    if (low < (uint32_t)count) {
+        uint32_t threshold = (uint32_t)(-(uint32_t)count) % (uint32_t)count;
+        while (low < threshold) {
+            product = (uint64_t)rng() * (uint64_t)count;
+            low = (uint32_t)product;
+        }
+    }
+    return (int)(product >> 32);
+}
+
+// Image of a set of cells under one of the 8 symmetries of the board
+BitBoard TransformCells(BitBoard cells, int symmetry) {
+    BitBoard image;
+    while (cells.Any()) {
+        int cell = cells.PopLowest();
+        int x = cell % GRID_SIZE;
+        int y = cell / GRID_SIZE;
+        if (symmetry & 1) x = GRID_SIZE - 1 - x;
+        if (symmetry & 2) y = GRID_SIZE - 1 - y;
+        if (symmetry & 4) std::swap(x, y);
+        image.Set(BitBoard::CellIndex(x, y));
+    }
+    return image;
+}
+
+// True for exactly one footprint of each class of footprints the board's
+// symmetries map onto each other
+bool IsCanonical(const BitBoard& footprint) {
+    for (int symmetry = 1; symmetry < 8; ++symmetry) {
+        BitBoard image = TransformCells(footprint, symmetry);
+        if (image.hi < footprint.hi || (image.hi == footprint.hi && image.lo < footprint.lo)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+bool GenerateRandomFleet(std::span<const int> shipSizes, std::mt19937& rng, std::span<ShipPlacement> placements,
+                         const BitBoard& existingShips, const BitBoard& blockedCells) {
+    int shipCount = (int)shipSizes.size();
+    if (shipCount > MAX_FLEET_SIZE || placements.size() < shipSizes.size()) {
+        return false;
+    }
+    for (int size : shipSizes) {
+        if (size < 1 || size > MAX_SHIP_SIZE) {
+            return false;
+        }
+    }
+    if (shipCount == 0) {
+        return true;
+    }
+    
+    // Place the largest ships first; they have the fewest legal anchors
+    std::array<int, MAX_FLEET_SIZE> order;
+    for (int i = 0; i < shipCount; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.begin() + shipCount,
+                     [&shipSizes](int a, int b) { return shipSizes[a] > shipSizes[b]; });
+    
+    std::array<SearchLevel, MAX_FLEET_SIZE> levels;
+    // Computes the anchors of a level that are legal next to the ships placed before it.
+    // A ship of the same size as the previous one is also limited to the previous
+    // level's untried anchors: any anchor already tried there would just reproduce
+    // a layout that has been explored with the two ships swapped.
+    auto buildAnchors = [&](int depth) {
+        SearchLevel& level = levels[depth];
+        int size = shipSizes[order[depth]];
+        BitBoard freeCells = BOARD_MASK & ~level.blockedBefore;
+        level.untried = ComputeAnchors(freeCells, size);
+        
+        if (depth > 0 && shipSizes[order[depth - 1]] == size) {
+            level.untried.horizontal &= levels[depth - 1].untried.horizontal;
+            level.untried.vertical &= levels[depth - 1].untried.vertical;
+        }
+    };
+    
+    int depth = 0;
+    levels[0].blockedBefore = blockedCells | existingShips.Dilate();
+    buildAnchors(0);
+    
+    while (depth >= 0) {
+        SearchLevel& level = levels[depth];
+        int horizontalCount = level.untried.horizontal.Count();
+        int count = horizontalCount + level.untried.vertical.Count();
+        if (count == 0) {
+            // Dead end: every anchor for this ship failed, revise the previous ship
+            depth--;
+            continue;
+        }
+        
+        // Draw an untried anchor and remove it so backtracking never retries it
+        int pick = RandomIndex(rng, count);
+        level.horizontal = pick < horizontalCount;
+        if (level.horizontal) {
+            level.anchor = level.untried.horizontal.NthIndex(pick);
+            level.untried.horizontal.Reset(level.anchor);
+        } else {
+            level.anchor = level.untried.vertical.NthIndex(pick - horizontalCount);
+            level.untried.vertical.Reset(level.anchor);
+        }
+        
+        if (depth + 1 == shipCount) {
+            break;
+        }
+        
+        int size = shipSizes[order[depth]];
+        levels[depth + 1].blockedBefore = level.blockedBefore | 
+            PLACEMENT_TABLE[size][level.horizontal ? 0 : 1][level.anchor].halo;
+        depth++;
+        buildAnchors(depth);
+    }
+    
+    if (depth < 0) {
+        return false;
+    }
+    
+    for (int i = 0; i < shipCount; ++i) {
+        int anchor = levels[i].anchor;
+        placements[order[i]] = {anchor % GRID_SIZE, anchor / GRID_SIZE, shipSizes[order[i]], levels[i].horizontal};
+    }
+    return true;
+}
+
+double SampleWeightedFleet(std::span<const int> shipSizes, std::mt19937& rng, std::span<ShipPlacement> placements,
+                           const BitBoard& existingShips, const BitBoard& blockedCells) {
+    if (placements.size() < shipSizes.size()) {
+        return 0.0;
+    }
+    
+    double weight = 1.0;
+    BitBoard blocked = blockedCells | existingShips.Dilate();
+    for (size_t i = 0; i < shipSizes.size(); ++i) {
+        int size = shipSizes[i];
+        if (size < 1 || size > MAX_SHIP_SIZE) {
+            return 0.0;
+        }
+        AnchorSet legal = ComputeAnchors(BOARD_MASK & ~blocked, size);
+        int horizontalCount = legal.horizontal.Count();
+        int count = horizontalCount + legal.vertical.Count();
+        if (count == 0) {
+            return 0.0;
+        }
+        
+        int pick = UniformIndex(rng, count);
+        bool horizontal = pick < horizontalCount;
+        int anchor = horizontal ? legal.horizontal.NthIndex(pick) : legal.vertical.NthIndex(pick - horizontalCount);
+        placements[i] = {anchor % GRID_SIZE, anchor / GRID_SIZE, size, horizontal};
+        blocked |= PLACEMENT_TABLE[size][horizontal ? 0 : 1][anchor].halo;
+        weight *= count;
+    }
+    return weight;
+}
+
+bool UniformFleetSampler::PrepareFleet(std::span<const int> shipSizes, std::mt19937& rng) {
+    int count = (int)shipSizes.size();
+    if (count == shipCount && std::equal(shipSizes.begin(), shipSizes.end(), fleetSizes.begin())) {
+        return feasible;
+    }
+    
+    shipCount = -1;
+    feasible = false;
+    attempts = 0;
+    samples = 0;
+    if (count > MAX_FLEET_SIZE) {
+        return false;
+    }
+    shipCount = count;
+    std::copy(shipSizes.begin(), shipSizes.end(), fleetSizes.begin());
+    
+    // GenerateRandomFleet validates the sizes and proves a layout exists,
+    // so the rejection loop in Sample always terminates
+    std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+    if (!GenerateRandomFleet(shipSizes, rng, std::span<ShipPlacement>(placements.data(), count))) {
+        return false;
+    }
+    
+    for (int i = 0; i < count; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.begin() + count,
+                     [this](int a, int b) { return fleetSizes[a] > fleetSizes[b]; });
+    
+    std::array<int, MAX_FLEET_SIZE> sortedSizes;
+    for (int i = 0; i < count; ++i) sortedSizes[i] = fleetSizes[order[i]];
+    stepBounds = SharedStepBounds(std::span<const int>(sortedSizes.data(), count));
+    feasible = true;
+    return true;
+}
+
+// The bounds depend only on the sizes, so every sampler in the process shares
+// one computation per fleet
+const std::array<int, MAX_FLEET_SIZE>& UniformFleetSampler::SharedStepBounds(std::span<const int> sortedSizes) {
+    static std::mutex mutex;
+    static std::map<std::vector<int>, std::array<int, MAX_FLEET_SIZE>> cache;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    auto [entry, inserted] = cache.try_emplace(std::vector<int>(sortedSizes.begin(), sortedSizes.end()));
+    if (inserted) {
+        entry->second.fill(0);
+        ComputeStepBounds(sortedSizes, 0, BitBoard(), entry->second);
+    }
+    return entry->second;
+}
+
+// Enumerates every legal placement of the first BOUND_DEPTH ships. Step i's bound
+// is the largest anchor count seen after the first min(i, BOUND_DEPTH) ships;
+// placing more ships only blocks cells, so deeper prefixes never see more.
+// Anchor counts don't change when the board is rotated or mirrored, so the
+// first ship only tries one placement per symmetry class.
+void UniformFleetSampler::ComputeStepBounds(std::span<const int> sortedSizes, int depth, const BitBoard& blocked,
+                                            std::array<int, MAX_FLEET_SIZE>& bounds) {
+    int count = (int)sortedSizes.size();
+    BitBoard freeCells = BOARD_MASK & ~blocked;
+    if (depth == BOUND_DEPTH || depth == count) {
+        // Equal sizes sit next to each other and see the same anchors
+        int anchorCount = 0;
+        for (int i = depth; i < count; ++i) {
+            if (i == depth || sortedSizes[i] != sortedSizes[i - 1]) {
+                AnchorSet anchors = ComputeAnchors(freeCells, sortedSizes[i]);
+                anchorCount = anchors.horizontal.Count() + anchors.vertical.Count();
+            }
+            bounds[i] = std::max(bounds[i], anchorCount);
+        }
+        return;
+    }
+    
+    int size = sortedSizes[depth];
+    AnchorSet anchors = ComputeAnchors(freeCells, size);
+    bounds[depth] = std::max(bounds[depth], anchors.horizontal.Count() + anchors.vertical.Count());
+    
+    // Deeper prefixes only see fewer anchors, so skip the subtree once none of
+    // the later steps could raise its bound here
+    bool canRaise = false;
+    int anchorCount = 0;
+    for (int i = depth + 1; i < count && !canRaise; ++i) {
+        if (sortedSizes[i] != sortedSizes[i - 1]) {
+            AnchorSet later = ComputeAnchors(freeCells, sortedSizes[i]);
+            anchorCount = later.horizontal.Count() + later.vertical.Count();
+        } else if (i == depth + 1) {
+            anchorCount = anchors.horizontal.Count() + anchors.vertical.Count();
+        }
+        canRaise = anchorCount > bounds[i];
+    }
+    if (!canRaise) {
+        return;
+    }
+    for (int orientation = 0; orientation < 2; ++orientation) {
+        BitBoard remaining = orientation == 0 ? anchors.horizontal : anchors.vertical;
+        while (remaining.Any()) {
+            const PlacementMasks& masks = PLACEMENT_TABLE[size][orientation][remaining.PopLowest()];
+            if (depth == 0 && !IsCanonical(masks.footprint)) {
+                continue;
+            }
+            ComputeStepBounds(sortedSizes, depth + 1, blocked | masks.halo, bounds);
+        }
+    }
+}
+
+bool UniformFleetSampler::Sample(std::span<const int> shipSizes, std::mt19937& rng, std::span<ShipPlacement> placements) {
+    if (placements.size() < shipSizes.size() || !PrepareFleet(shipSizes, rng)) {
+        return false;
+    }
+    
+    std::array<int, MAX_FLEET_SIZE> anchors;
+    std::array<bool, MAX_FLEET_SIZE> horizontal;
+    bool accepted = false;
+    while (!accepted) {
+        attempts++;
+        accepted = true;
+        BitBoard blocked;
+        for (int i = 0; i < shipCount; ++i) {
+            int size = fleetSizes[order[i]];
+            AnchorSet legal = ComputeAnchors(BOARD_MASK & ~blocked, size);
+            int horizontalCount = legal.horizontal.Count();
+            int pick = UniformIndex(rng, stepBounds[i]);
+            if (pick >= horizontalCount + legal.vertical.Count()) {
+                accepted = false;
+                break;
+            }
+            
+            horizontal[i] = pick < horizontalCount;
+            anchors[i] = horizontal[i] ? legal.horizontal.NthIndex(pick)
+                                       : legal.vertical.NthIndex(pick - horizontalCount);
+            blocked |= PLACEMENT_TABLE[size][horizontal[i] ? 0 : 1][anchors[i]].halo;
+        }
+    }
+    samples++;
+    
+    for (int i = 0; i < shipCount; ++i) {
+        placements[order[i]] = {anchors[i] % GRID_SIZE, anchors[i] / GRID_SIZE, fleetSizes[order[i]], horizontal[i]};
+    }
+    return true;
+}
+
+double UniformFleetSampler::GetAttemptsPerSample() const {
+    return samples > 0 ? (double)attempts / (double)samples : 0.0;
+}
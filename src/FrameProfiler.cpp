@@ -0,0 +1,125 @@
+#include "FrameProfiler.h"
+#include "Log.h"
+#include <algorithm>
+
+const char* GetProfilePhaseName(ProfilePhase phase) {
+    switch (phase) {
+        case ProfilePhase::Frame: return "Frame";
+        case ProfilePhase::HandleEvents: return "HandleEvents";
+        case ProfilePhase::Update: return "Update";
+        case ProfilePhase::AITurn: return "AITurn";
+        case ProfilePhase::Render: return "Render";
+        case ProfilePhase::RenderGrid: return "RenderGrid";
+        case ProfilePhase::RenderText: return "RenderText";
+        case ProfilePhase::RenderUI: return "RenderUI";
+        case ProfilePhase::Present: return "Present";
+        case ProfilePhase::Count: break;
+    }
+    return "?";
+}
+
+FrameProfiler::FrameProfiler()
+    : enabled(false), overlayVisible(false), ticksToMicroseconds(1e6 / (double)SDL_GetPerformanceFrequency()),
+      traceOrigin(0), firstTraceEvent(true) {
+    frameTicks.fill(0);
+    frameSeen.fill(false);
+}
+
+FrameProfiler::~FrameProfiler() {
+    StopTrace();
+}
+
+void FrameProfiler::SetOverlayVisible(bool visible) {
+    overlayVisible = visible;
+    UpdateEnabled();
+}
+
+bool FrameProfiler::StartTrace(const std::string& path) {
+    StopTrace();
+    traceFile.open(path, std::ios::out | std::ios::trunc);
+    if (!traceFile) {
+        LOG_WARN(LogCategory::Profiler, "Could not open trace file {}", path);
+        return false;
+    }
+    // Array form of the trace-event format; viewers accept it unterminated too
+    traceFile << "[\n";
+    traceOrigin = SDL_GetPerformanceCounter();
+    firstTraceEvent = true;
+    pendingEvents.clear();
+    UpdateEnabled();
+    return true;
+}
+
+void FrameProfiler::StopTrace() {
+    if (!traceFile.is_open()) return;
+    FlushTrace();
+    traceFile << "\n]\n";
+    traceFile.close();
+    UpdateEnabled();
+}
+
+void FrameProfiler::Record(ProfilePhase phase, Uint64 start, Uint64 end) {
+    int index = (int)phase;
+    frameTicks[index] += end - start;
+    frameSeen[index] = true;
+    if (traceFile.is_open()) {
+        pendingEvents.push_back({phase, start, end});
+    }
+}
+
+void FrameProfiler::EndFrame() {
+    for (int i = 0; i < (int)ProfilePhase::Count; ++i) {
+        // Phases that didn't run this frame (no AI turn, no redraw) leave
+        // their window alone rather than filling it with zeros
+        if (!frameSeen[i]) continue;
+        PhaseWindow& window = windows[i];
+        window.microseconds[window.next] = (float)(frameTicks[i] * ticksToMicroseconds);
+        window.next = (window.next + 1) % WINDOW_FRAMES;
+        window.count = std::min(window.count + 1, WINDOW_FRAMES);
+        frameTicks[i] = 0;
+        frameSeen[i] = false;
+    }
+    FlushTrace();
+}
+
+void FrameProfiler::FlushTrace() {
+    if (!traceFile.is_open() || pendingEvents.empty()) return;
+    for (const TraceEvent& event : pendingEvents) {
+        // Events from before the trace started would get negative timestamps
+        if (event.start < traceOrigin) continue;
+        traceFile << (firstTraceEvent ? "" : ",\n") << "{\"name\":\"" << GetProfilePhaseName(event.phase)
+                  << "\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":" << (event.start - traceOrigin) * ticksToMicroseconds
+                  << ",\"dur\":" << (event.end - event.start) * ticksToMicroseconds << "}";
+        firstTraceEvent = false;
+    }
+    pendingEvents.clear();
+}
+
+FrameProfiler::PhaseSummary FrameProfiler::Summarize(ProfilePhase phase) const {
+    const PhaseWindow& window = windows[(int)phase];
+    PhaseSummary summary;
+    summary.samples = window.count;
+    if (window.count == 0) return summary;
+
+    std::array<float, WINDOW_FRAMES> sorted;
+    double total = 0.0;
+    for (int i = 0; i < window.count; ++i) {
+        float microseconds = window.microseconds[i];
+        sorted[i] = microseconds;
+        total += microseconds;
+
+        int bucket = 0;
+        for (float limit = 16.0f; microseconds >= limit && bucket < HISTOGRAM_BUCKETS - 1; limit *= 2.0f) {
+            bucket++;
+        }
+        summary.histogram[bucket]++;
+    }
+    std::sort(sorted.begin(), sorted.begin() + window.count);
+
+    int last = (window.next + WINDOW_FRAMES - 1) % WINDOW_FRAMES;
+    summary.lastMs = window.microseconds[last] / 1000.0;
+    summary.meanMs = total / window.count / 1000.0;
+    summary.p95Ms = sorted[std::min(window.count - 1, (int)(0.95 * window.count))] / 1000.0;
+    summary.maxMs = sorted[window.count - 1] / 1000.0;
+    return summary;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include <SDL3/SDL.h>
+#include <array>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Phases of one pass through the game loop. Nested phases (AITurn inside
+// Update, the render passes inside Render) are timed separately, not
+// subtracted from their parent.
+enum class ProfilePhase {
+    Frame,
+    HandleEvents,
+    Update,
+    AITurn,
+    Render,
+    RenderGrid,
+    RenderText,
+    RenderUI,
+    Present,
+    Count
+};
+
+const char* GetProfilePhaseName(ProfilePhase phase);
+
+// Per-phase timings from SDL_GetPerformanceCounter, kept as rolling windows
+// for the on-screen overlay and optionally streamed to a Chrome trace-event
+// file (load it in chrome://tracing or Perfetto). While neither the overlay
+// nor the trace wants data, every scope costs one predictable branch.
+class FrameProfiler {
+public:
+    static constexpr int WINDOW_FRAMES = 120;
+    static constexpr int HISTOGRAM_BUCKETS = 8;
+
+    struct PhaseSummary {
+        int samples = 0;
+        double lastMs = 0.0;
+        double meanMs = 0.0;
+        double p95Ms = 0.0;
+        double maxMs = 0.0;
+        // Log2 buckets of the window: under 16 us, doubling up to 1 ms and over
+        std::array<int, HISTOGRAM_BUCKETS> histogram{};
+    };
+
+    FrameProfiler();
+    ~FrameProfiler();
+
+    FrameProfiler(const FrameProfiler&) = delete;
+    FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+    bool IsEnabled() const { return enabled; }
+
+    void SetOverlayVisible(bool visible);
+    bool IsOverlayVisible() const { return overlayVisible; }
+
+    // Starts or stops streaming to a trace file; false if it can't be opened
+    bool StartTrace(const std::string& path);
+    void StopTrace();
+    bool IsTracing() const { return traceFile.is_open(); }
+
+    // Closes the frame: folds this frame's phase totals into the windows and
+    // flushes buffered trace events
+    void EndFrame();
+
+    void Record(ProfilePhase phase, Uint64 start, Uint64 end);
+
+    PhaseSummary Summarize(ProfilePhase phase) const;
+
+private:
+    struct PhaseWindow {
+        std::array<float, WINDOW_FRAMES> microseconds{};
+        int next = 0;
+        int count = 0;
+    };
+
+    struct TraceEvent {
+        ProfilePhase phase;
+        Uint64 start;
+        Uint64 end;
+    };
+
+    bool enabled;
+    bool overlayVisible;
+    double ticksToMicroseconds;
+    Uint64 traceOrigin;
+    bool firstTraceEvent;
+
+    std::array<PhaseWindow, (int)ProfilePhase::Count> windows;
+    std::array<Uint64, (int)ProfilePhase::Count> frameTicks; // Summed over the frame
+    std::array<bool, (int)ProfilePhase::Count> frameSeen;
+    std::vector<TraceEvent> pendingEvents;
+    std::ofstream traceFile;
+
+    void UpdateEnabled() { enabled = overlayVisible || traceFile.is_open(); }
+    void FlushTrace();
+};
+
+// Times the enclosing scope into one phase
+class ProfileScope {
+public:
+    ProfileScope(FrameProfiler& profiler, ProfilePhase phase)
+        : profiler(profiler.IsEnabled() ? &profiler : nullptr), phase(phase),
+          start(this->profiler ? SDL_GetPerformanceCounter() : 0) {}
+
+    ~ProfileScope() {
+        if (profiler) {
+            profiler->Record(phase, start, SDL_GetPerformanceCounter());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    FrameProfiler* profiler;
+    ProfilePhase phase;
+    Uint64 start;
+};
@@ -0,0 +1,117 @@
+#include "GameIndex.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace GameIndexFormat;
+
+bool BuildGameIndex(std::span<const uint8_t> records, const std::string& path, std::string& error) {
+    GameRecordReader reader(records);
+    if (!reader.HasValidHeader()) {
+        error = "not a game-record file";
+        return false;
+    }
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        error = "cannot create " + path;
+        return false;
+    }
+
+    // The offsets are written as the games go by; the header, which counts
+    // them, goes in last over this placeholder
+    GameIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    GameRecordView view;
+    uint32_t game = 0;
+    for (; written && reader.Next(view); ++game) {
+        if (game % GAMES_PER_ENTRY == 0) {
+            written = std::fwrite(&view.offset, sizeof(view.offset), 1, file) == 1;
+            ++header.entryCount;
+        }
+    }
+    if (written && reader.HasError()) {
+        error = "corrupt or truncated game at offset " + std::to_string(reader.GetOffset());
+        std::fclose(file);
+        std::remove(path.c_str());
+        return false;
+    }
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.gamesPerEntry = GAMES_PER_ENTRY;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.gameCount = game;
+    header.recordFileSize = records.size();
+    written = written && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    written = std::fclose(file) == 0 && written;
+    if (!written) {
+        error = "cannot write " + path;
+        std::remove(path.c_str());
+    }
+    return written;
+}
+
+bool GameIndex::Open(const std::string& path, uint64_t recordFileSize, std::string& error) {
+    header = nullptr;
+    offsets = {};
+    if (!file.Open(path, error)) {
+        return false;
+    }
+    std::span<const uint8_t> bytes = file.GetBytes();
+    const auto* candidate = reinterpret_cast<const GameIndexHeader*>(bytes.data());
+    if (bytes.size() < sizeof(GameIndexHeader) || std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        candidate->version != VERSION || candidate->byteOrderMark != BYTE_ORDER_MARK ||
+        candidate->gamesPerEntry == 0) {
+        error = path + " is not a game index for this machine";
+    } else if (candidate->recordFileSize != recordFileSize) {
+        error = path + " is out of date";
+    } else if (bytes.size() != sizeof(GameIndexHeader) + candidate->entryCount * sizeof(uint64_t) ||
+               candidate->entryCount != (candidate->gameCount + candidate->gamesPerEntry - 1) / candidate->gamesPerEntry) {
+        error = path + " is truncated";
+    } else {
+        header = candidate;
+        offsets = {reinterpret_cast<const uint64_t*>(bytes.data() + sizeof(GameIndexHeader)),
+                   (size_t)candidate->entryCount};
+        return true;
+    }
+    file.Close();
+    return false;
+}
+
+bool GameIndex::Find(uint32_t game, uint32_t& indexedGame, uint64_t& offset) const {
+    if (!header || game >= header->gameCount) {
+        return false;
+    }
+    size_t entry = game / header->gamesPerEntry;
+    indexedGame = (uint32_t)(entry * header->gamesPerEntry);
+    offset = offsets[entry];
+    return true;
+}
+
+bool SeekRecordedGame(const GameIndex& index, std::span<const uint8_t> records, uint32_t gameNumber, int shot,
+                      Match& match, GameRecordView& game) {
+    uint32_t indexedGame;
+    uint64_t offset;
+    if (!index.Find(gameNumber, indexedGame, offset)) {
+        return false;
+    }
+    GameRecordReader reader(records);
+    reader.Seek(offset);
+    for (uint32_t i = indexedGame; i <= gameNumber; ++i) {
+        if (!reader.Next(game)) {
+            return false;
+        }
+    }
+    if (shot > game.GetShotCount() || !SetUpRecordedMatch(game, match)) {
+        return false;
+    }
+    for (int i = 0; i < shot; ++i) {
+        RecordedShot recorded = game.GetShot(i);
+        ShotOutcome outcome;
+        if (!match.Fire(recorded.x, recorded.y, outcome)) {
+            return false;
+        }
+    }
+    return true;
+}
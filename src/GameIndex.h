@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include "GameRecord.h"
+#include "MappedFile.h"
+#include "Match.h"
+
+// Sparse index for a game-record file, kept next to it as <file>.idx. It
+// holds the byte offset of every GAMES_PER_ENTRY-th game, so reaching game N,
+// shot M takes one lookup, a skip over fewer than GAMES_PER_ENTRY game
+// headers and a replay of M shots from the game's own fleets. At 8 bytes per
+// entry the index stays a fraction of a percent of the record file.
+//
+// The file is a header followed by the offsets in game order, memory-mapped
+// and read in place. It is in native byte order; being derived data, it is
+// simply rebuilt when it doesn't fit.
+namespace GameIndexFormat {
+constexpr char MAGIC[4] = {'B', 'S', 'G', 'I'};
+constexpr uint16_t VERSION = 2;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+constexpr int GAMES_PER_ENTRY = 16;
+} // namespace GameIndexFormat
+
+struct GameIndexHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t gamesPerEntry;
+    uint32_t byteOrderMark;
+    uint32_t gameCount;
+    uint64_t recordFileSize; // When indexed, to spot an index left over from an older file
+    uint64_t entryCount;
+};
+
+static_assert(std::is_trivially_copyable_v<GameIndexHeader>);
+static_assert(sizeof(GameIndexHeader) % alignof(uint64_t) == 0, "offsets must stay aligned in the mapping");
+
+inline std::string GetGameIndexPath(const std::string& recordPath) {
+    return recordPath + ".idx";
+}
+
+// Walks the games of a record file and streams its index to path
+bool BuildGameIndex(std::span<const uint8_t> records, const std::string& path, std::string& error);
+
+class GameIndex {
+public:
+    // Maps an index, failing if it was not built for a record file of recordFileSize bytes
+    bool Open(const std::string& path, uint64_t recordFileSize, std::string& error);
+    bool IsOpen() const { return header != nullptr; }
+
+    uint32_t GetGameCount() const { return header ? header->gameCount : 0; }
+    size_t GetEntryCount() const { return offsets.size(); }
+
+    // The latest indexed game at or before this one, and its offset in the
+    // record file; false if the file has no such game
+    bool Find(uint32_t game, uint32_t& indexedGame, uint64_t& offset) const;
+
+private:
+    MappedFile file;
+    const GameIndexHeader* header = nullptr;
+    std::span<const uint64_t> offsets;
+};
+
+// Sets the match to where the game stood after its first `shot` shots, with
+// the game's view in `game` so a replay can carry on from there
+bool SeekRecordedGame(const GameIndex& index, std::span<const uint8_t> records, uint32_t gameNumber, int shot,
+                      Match& match, GameRecordView& game);
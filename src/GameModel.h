@@ -0,0 +1,24 @@
+#pragma once
+#include <type_traits>
+#include "Grid.h"
+#include "Match.h"
+#include "Ship.h"
+
+// Everything a game of the front end shows and the rules act on, as one flat
+// value: the match with both fleets, what the player knows of the AI grid, and
+// how far the player got placing ships. Nothing in it lives on the heap or
+// points elsewhere, so a position is cloned with a plain copy and models can
+// be kept side by side in one array. The AI's search state is not part of it.
+struct GameModel {
+    Match match;
+    Grid targetGrid;     // What the player knows of the AI grid
+    ShipManager fleet;   // The player's ships and placement cursor
+
+    void Reset() {
+        match.Reset();
+        targetGrid.Reset();
+        fleet.Reset();
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<GameModel>, "GameModel must stay memcpy-able");
@@ -0,0 +1,198 @@
+#include "GameRecord.h"
+#include <cstring>
+
+using namespace GameRecordFormat;
+
+namespace {
+
+void AppendShips(std::vector<uint8_t>& out, const Grid& grid) {
+    for (int id = 0; id < grid.GetShipCount(); ++id) {
+        const BitBoard& cells = grid.GetShipCells(id);
+        int anchor = cells.LowestIndex();
+        int size = cells.Count();
+        bool horizontal = size == 1 || cells.Test(anchor + 1);
+        out.push_back((uint8_t)anchor);
+        out.push_back((uint8_t)(size << 1 | (horizontal ? 1 : 0)));
+    }
+}
+
+} // namespace
+
+void GameRecordEncoder::WriteFileHeader(std::vector<uint8_t>& out) {
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    out.push_back(VERSION);
+    out.insert(out.end(), FILE_HEADER_SIZE - 5, 0); // Reserved
+}
+
+void GameRecordEncoder::BeginGame(uint64_t seed, Side firstToMove, const Match& match) {
+    bytes.push_back(GAME_MARKER);
+    for (int i = 0; i < 8; ++i) {
+        bytes.push_back((uint8_t)(seed >> (8 * i)));
+    }
+    bytes.push_back((uint8_t)firstToMove);
+    bytes.push_back((uint8_t)match.GetGrid(Side::Player).GetShipCount());
+    bytes.push_back((uint8_t)match.GetGrid(Side::AI).GetShipCount());
+    AppendShips(bytes, match.GetGrid(Side::Player));
+    AppendShips(bytes, match.GetGrid(Side::AI));
+    inGame = true;
+}
+
+void GameRecordEncoder::RecordShot(Side shooter, int x, int y, const ShotOutcome& outcome) {
+    uint8_t flags = shooter == Side::AI ? SHOT_BY_AI : 0;
+    if (outcome.result != ShotResult::Miss) flags |= SHOT_HIT;
+    if (outcome.result == ShotResult::Sunk) flags |= SHOT_SUNK;
+    bytes.push_back((uint8_t)(y * GRID_SIZE + x));
+    bytes.push_back(flags);
+}
+
+void GameRecordEncoder::EndGame(Side winner, bool abandoned) {
+    bytes.push_back(END_MARKER);
+    bytes.push_back((uint8_t)((uint8_t)winner | (abandoned ? GAME_ABANDONED : 0)));
+    inGame = false;
+}
+
+GameRecordWriter::~GameRecordWriter() {
+    Close();
+}
+
+bool GameRecordWriter::Open(const std::string& path) {
+    Close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) return false;
+    encoder.Clear();
+    std::vector<uint8_t> header;
+    GameRecordEncoder::WriteFileHeader(header);
+    bytesWritten = std::fwrite(header.data(), 1, header.size(), file);
+    return true;
+}
+
+void GameRecordWriter::Close() {
+    if (!file) return;
+    if (encoder.IsInGame()) {
+        encoder.EndGame(Side::Player, true);
+    }
+    Flush();
+    std::fclose(file);
+    file = nullptr;
+}
+
+void GameRecordWriter::BeginGame(uint64_t seed, Side firstToMove, const Match& match) {
+    if (!file) return;
+    if (encoder.IsInGame()) {
+        encoder.EndGame(Side::Player, true);
+    }
+    encoder.BeginGame(seed, firstToMove, match);
+}
+
+void GameRecordWriter::RecordShot(Side shooter, int x, int y, const ShotOutcome& outcome) {
+    if (!file || !encoder.IsInGame()) return;
+    encoder.RecordShot(shooter, x, y, outcome);
+    if (encoder.GetBytes().size() >= FLUSH_THRESHOLD) {
+        Flush();
+    }
+}
+
+void GameRecordWriter::EndGame(Side winner) {
+    if (!file || !encoder.IsInGame()) return;
+    encoder.EndGame(winner);
+    Flush();
+}
+
+void GameRecordWriter::AppendGames(std::span<const uint8_t> games) {
+    if (!file) return;
+    Flush();
+    bytesWritten += std::fwrite(games.data(), 1, games.size(), file);
+}
+
+void GameRecordWriter::Flush() {
+    const std::vector<uint8_t>& pending = encoder.GetBytes();
+    if (!pending.empty()) {
+        bytesWritten += std::fwrite(pending.data(), 1, pending.size(), file);
+        encoder.Clear();
+    }
+    std::fflush(file);
+}
+
+ShipPlacement GameRecordView::GetShip(Side side, int index) const {
+    const uint8_t* entry = ships[(int)side].data() + 2 * index;
+    return {entry[0] % GRID_SIZE, entry[0] / GRID_SIZE, entry[1] >> 1, (entry[1] & 1) != 0};
+}
+
+RecordedShot GameRecordView::GetShot(int index) const {
+    const uint8_t* entry = shots.data() + 2 * index;
+    return {entry[0] % GRID_SIZE, entry[0] / GRID_SIZE, (entry[1] & SHOT_BY_AI) ? Side::AI : Side::Player,
+            (entry[1] & SHOT_HIT) != 0, (entry[1] & SHOT_SUNK) != 0};
+}
+
+GameRecordReader::GameRecordReader(std::span<const uint8_t> bytes)
+    : bytes(bytes), position(FILE_HEADER_SIZE), validHeader(false), error(false) {
+    validHeader = bytes.size() >= FILE_HEADER_SIZE && std::memcmp(bytes.data(), MAGIC, 4) == 0 &&
+                  bytes[4] == VERSION;
+    if (!validHeader) {
+        position = bytes.size();
+        error = true;
+    }
+}
+
+void GameRecordReader::Seek(uint64_t offset) {
+    if (!validHeader) return;
+    position = offset;
+    error = false;
+}
+
+bool GameRecordReader::Next(GameRecordView& game) {
+    if (error || position >= bytes.size()) return false;
+
+    const uint8_t* start = bytes.data() + position;
+    size_t available = bytes.size() - position;
+    constexpr size_t FIXED_HEADER = 1 + 8 + 1 + 2;
+    if (available < FIXED_HEADER || start[0] != GAME_MARKER) {
+        error = true;
+        return false;
+    }
+    game.offset = position;
+    game.seed = 0;
+    for (int i = 0; i < 8; ++i) {
+        game.seed |= (uint64_t)start[1 + i] << (8 * i);
+    }
+    game.firstToMove = start[9] ? Side::AI : Side::Player;
+    size_t shipBytes[2] = {2u * start[10], 2u * start[11]};
+    size_t cursor = FIXED_HEADER;
+    if (available < cursor + shipBytes[0] + shipBytes[1]) {
+        error = true;
+        return false;
+    }
+    game.ships[0] = {start + cursor, shipBytes[0]};
+    cursor += shipBytes[0];
+    game.ships[1] = {start + cursor, shipBytes[1]};
+    cursor += shipBytes[1];
+
+    // Shots run up to the end marker; a cell byte never reaches it
+    size_t shotsStart = cursor;
+    while (cursor + 2 <= available && start[cursor] != END_MARKER) {
+        cursor += 2;
+    }
+    if (cursor + 2 > available) {
+        error = true; // Truncated, e.g. the writer was killed mid-game
+        return false;
+    }
+    game.shots = {start + shotsStart, cursor - shotsStart};
+    game.winner = (start[cursor + 1] & 1) ? Side::AI : Side::Player;
+    game.abandoned = (start[cursor + 1] & GAME_ABANDONED) != 0;
+    position += cursor + 2;
+    return true;
+}
+
+bool SetUpRecordedMatch(const GameRecordView& game, Match& match) {
+    match.Reset();
+    for (int side = 0; side < 2; ++side) {
+        for (int i = 0; i < game.GetShipCount((Side)side); ++i) {
+            ShipPlacement ship = game.GetShip((Side)side, i);
+            if (!match.PlaceShip((Side)side, ship.x, ship.y, ship.size, ship.horizontal)) {
+                return false;
+            }
+        }
+    }
+    match.StartBattle(game.firstToMove);
+    return true;
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+#include "FleetGenerator.h"
+#include "Match.h"
+
+// Binary match records. A file is an 8-byte header followed by any number of
+// games, each laid out as
+//
+//     u8  GAME_MARKER
+//     u64 seed (little-endian)
+//     u8  side to move first
+//     u8  ship count, player side    u8 ship count, AI side
+//     2 bytes per ship, player ships then AI ships: anchor cell, size << 1 | horizontal
+//     2 bytes per shot: cell, SHOT_* flags
+//     u8  END_MARKER, u8 winner | GAME_ABANDONED
+//
+// where a cell is y * GRID_SIZE + x. A typical game takes about 250 bytes.
+namespace GameRecordFormat {
+constexpr char MAGIC[4] = {'B', 'S', 'G', 'R'};
+constexpr uint8_t VERSION = 1;
+constexpr size_t FILE_HEADER_SIZE = 8;
+constexpr uint8_t GAME_MARKER = 0xA5;
+constexpr uint8_t END_MARKER = 0xFF;
+constexpr uint8_t SHOT_BY_AI = 0x01;
+constexpr uint8_t SHOT_HIT = 0x02;
+constexpr uint8_t SHOT_SUNK = 0x04;
+constexpr uint8_t GAME_ABANDONED = 0x80;
+} // namespace GameRecordFormat
+
+struct RecordedShot {
+    int x;
+    int y;
+    Side shooter;
+    bool hit;
+    bool sunk;
+};
+
+// Builds the bytes of one game at a time in memory
+class GameRecordEncoder {
+public:
+    // Records both fleets as currently placed in the match
+    void BeginGame(uint64_t seed, Side firstToMove, const Match& match);
+    void RecordShot(Side shooter, int x, int y, const ShotOutcome& outcome);
+    void EndGame(Side winner, bool abandoned = false);
+    bool IsInGame() const { return inGame; }
+
+    const std::vector<uint8_t>& GetBytes() const { return bytes; }
+    void Clear() { bytes.clear(); }
+
+    static void WriteFileHeader(std::vector<uint8_t>& out);
+
+private:
+    std::vector<uint8_t> bytes;
+    bool inGame = false;
+};
+
+// Streams games to a file. Bytes are written once a game ends or the buffer
+// fills up, so recording costs a few bytes of memory traffic per shot.
+class GameRecordWriter {
+public:
+    GameRecordWriter() = default;
+    ~GameRecordWriter();
+
+    GameRecordWriter(const GameRecordWriter&) = delete;
+    GameRecordWriter& operator=(const GameRecordWriter&) = delete;
+
+    // Creates or truncates the file and writes its header
+    bool Open(const std::string& path);
+    // Marks an unfinished game as abandoned and flushes
+    void Close();
+    bool IsOpen() const { return file != nullptr; }
+
+    // An unfinished previous game is ended as abandoned first
+    void BeginGame(uint64_t seed, Side firstToMove, const Match& match);
+    void RecordShot(Side shooter, int x, int y, const ShotOutcome& outcome);
+    void EndGame(Side winner);
+
+    // Appends complete games encoded elsewhere, e.g. on another thread
+    void AppendGames(std::span<const uint8_t> games);
+
+    uint64_t GetBytesWritten() const { return bytesWritten; }
+
+private:
+    static constexpr size_t FLUSH_THRESHOLD = 64 * 1024;
+
+    std::FILE* file = nullptr;
+    GameRecordEncoder encoder;
+    uint64_t bytesWritten = 0;
+
+    void Flush();
+};
+
+// Zero-copy view of one recorded game; its spans point into the reader's bytes
+struct GameRecordView {
+    uint64_t offset = 0; // Of the game marker, from the start of the file
+    uint64_t seed = 0;
+    Side firstToMove = Side::Player;
+    Side winner = Side::Player;
+    bool abandoned = false;
+    std::span<const uint8_t> ships[2];
+    std::span<const uint8_t> shots;
+
+    int GetShipCount(Side side) const { return (int)ships[(int)side].size() / 2; }
+    ShipPlacement GetShip(Side side, int index) const;
+    int GetShotCount() const { return (int)shots.size() / 2; }
+    RecordedShot GetShot(int index) const;
+};
+
+// Walks the games of a record file held in memory, typically a MappedFile
+class GameRecordReader {
+public:
+    explicit GameRecordReader(std::span<const uint8_t> bytes);
+
+    bool HasValidHeader() const { return validHeader; }
+
+    // False at the end of the data, or at a corrupt or truncated game
+    // (then HasError is true and GetOffset points at it)
+    bool Next(GameRecordView& game);
+    bool HasError() const { return error; }
+    uint64_t GetOffset() const { return position; }
+    // Continues from a game boundary found elsewhere, e.g. in an index
+    void Seek(uint64_t offset);
+
+private:
+    std::span<const uint8_t> bytes;
+    uint64_t position;
+    bool validHeader;
+    bool error;
+};
+
+// Sets a match up with the recorded fleets, ready for the first shot
+bool SetUpRecordedMatch(const GameRecordView& game, Match& match);
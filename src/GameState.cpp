@@ -1,5 +1,13 @@
 #include "GameState.h"
 
+const char* GetVictoryMessageText(VictoryMessage message) {
+    switch (message) {
+        case VictoryMessage::PlayerWins: return "VICTORY - YOU WIN!";
+        case VictoryMessage::AIWins: return "GAME OVER - AI WINS!";
+        default: return "";
+    }
+}
+
 GameState::GameState() {
     Reset();
 }
@@ -7,9 +15,32 @@ GameState::GameState() {
 void GameState::Reset() {
     currentState = GameStateType::ShipPlacement;
     gameEnded = false;
-    victoryMessage = "";
+    victoryMessage = VictoryMessage::None;
     isPlayerTurn = true;
     playerShipsRemaining = 0;
     aiShipsRemaining = 0;
+    playerCellsRemaining = 0;
+    aiCellsRemaining = 0;
+}
+
+void GameState::InitializeFleets(int playerShips, int playerCells, int aiShips, int aiCells) {
+    playerShipsRemaining = playerShips;
+    playerCellsRemaining = playerCells;
+    aiShipsRemaining = aiShips;
+    aiCellsRemaining = aiCells;
+}
+
+void GameState::RegisterPlayerShipHit(bool sunk) {
+    playerCellsRemaining--;
+    if (sunk) {
+        playerShipsRemaining--;
+    }
+}
+
+void GameState::RegisterAIShipHit(bool sunk) {
+    aiCellsRemaining--;
+    if (sunk) {
+        aiShipsRemaining--;
+    }
 }
 
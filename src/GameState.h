@@ -1,5 +1,7 @@
 #pragma once
-#include <string>
+#include <cstdint>
+
+constexpr int GRID_SIZE = 10;
 
 enum class GameStateType {
     ShipPlacement,
@@ -7,7 +9,7 @@ enum class GameStateType {
     GameOver
 };
 
-enum class CellState {
+enum class CellState : uint8_t {
     Empty,
     Ship,
     Hit,
@@ -16,6 +18,22 @@ enum class CellState {
     InvalidPreview
 };
 
+enum class ShotResult {
+    Miss,
+    Hit,
+    Sunk,
+    AlreadyShot // The cell was shot before; nothing changed
+};
+
+// Game-over banners; the text lives in a static table
+enum class VictoryMessage : uint8_t {
+    None,
+    PlayerWins,
+    AIWins,
+};
+
+const char* GetVictoryMessageText(VictoryMessage message);
+
 struct GridPosition {
     int x, y;
     
@@ -37,8 +55,8 @@ public:
     bool IsGameEnded() const { return gameEnded; }
     void SetGameEnded(bool ended) { gameEnded = ended; }
     
-    const std::string& GetVictoryMessage() const { return victoryMessage; }
-    void SetVictoryMessage(const std::string& message) { victoryMessage = message; }
+    const char* GetVictoryMessage() const { return GetVictoryMessageText(victoryMessage); }
+    void SetVictoryMessage(VictoryMessage message) { victoryMessage = message; }
     
     bool IsPlayerTurn() const { return isPlayerTurn; }
     void SetPlayerTurn(bool playerTurn) { isPlayerTurn = playerTurn; }
@@ -48,12 +66,22 @@ public:
     
     int GetAIShipsRemaining() const { return aiShipsRemaining; }
     void SetAIShipsRemaining(int count) { aiShipsRemaining = count; }
+    
+    int GetPlayerCellsRemaining() const { return playerCellsRemaining; }
+    int GetAICellsRemaining() const { return aiCellsRemaining; }
+    
+    // Fleet health is tracked incrementally as shots land
+    void InitializeFleets(int playerShips, int playerCells, int aiShips, int aiCells);
+    void RegisterPlayerShipHit(bool sunk);
+    void RegisterAIShipHit(bool sunk);
 
 private:
     GameStateType currentState;
     bool gameEnded;
-    std::string victoryMessage;
+    VictoryMessage victoryMessage;
     bool isPlayerTurn;
     int playerShipsRemaining;
     int aiShipsRemaining;
+    int playerCellsRemaining;
+    int aiCellsRemaining;
 };
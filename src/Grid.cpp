@@ -1,16 +1,20 @@
 #include "Grid.h"
-#include "Renderer.h"
 
 Grid::Grid() {
     Clear();
 }
 
 void Grid::Clear() {
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            grid[i][j] = CellState::Empty;
-        }
-    }
+    shipMask = BitBoard();
+    hitMask = BitBoard();
+    missMask = BitBoard();
+    previewMask = BitBoard();
+    invalidPreviewMask = BitBoard();
+    shipIds.fill(NO_SHIP);
+    shipHealth.fill(0);
+    shipCells.fill(BitBoard());
+    shipCount = 0;
+    gridViewDirty = true;
 }
 
 void Grid::Reset() {
@@ -21,13 +25,54 @@ CellState Grid::GetCell(int x, int y) const {
     if (!IsValidPosition(x, y)) {
         return CellState::Empty;
     }
-    return grid[y][x];
+    
+    int index = BitBoard::CellIndex(x, y);
+    if (shipMask.Test(index)) return CellState::Ship;
+    if (hitMask.Test(index)) return CellState::Hit;
+    if (missMask.Test(index)) return CellState::Miss;
+    if (previewMask.Test(index)) return CellState::Preview;
+    if (invalidPreviewMask.Test(index)) return CellState::InvalidPreview;
+    return CellState::Empty;
 }
 
 void Grid::SetCell(int x, int y, CellState state) {
-    if (IsValidPosition(x, y)) {
-        grid[y][x] = state;
+    if (!IsValidPosition(x, y)) {
+        return;
+    }
+    
+    int index = BitBoard::CellIndex(x, y);
+    
+    // A ship cell turning into a hit costs its ship one remaining hit
+    if (state == CellState::Hit && shipMask.Test(index) && shipIds[index] != NO_SHIP) {
+        shipHealth[shipIds[index]]--;
+    }
+    
+    shipMask.Reset(index);
+    hitMask.Reset(index);
+    missMask.Reset(index);
+    previewMask.Reset(index);
+    invalidPreviewMask.Reset(index);
+    
+    switch (state) {
+        case CellState::Ship:
+            shipMask.Set(index);
+            break;
+        case CellState::Hit:
+            hitMask.Set(index);
+            break;
+        case CellState::Miss:
+            missMask.Set(index);
+            break;
+        case CellState::Preview:
+            previewMask.Set(index);
+            break;
+        case CellState::InvalidPreview:
+            invalidPreviewMask.Set(index);
+            break;
+        default:
+            break;
     }
+    gridViewDirty = true;
 }
 
 bool Grid::IsValidPosition(int x, int y) const {
@@ -35,27 +80,71 @@ bool Grid::IsValidPosition(int x, int y) const {
 }
 
 void Grid::ClearPreview() {
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            if (grid[i][j] == CellState::Preview || grid[i][j] == CellState::InvalidPreview) {
-                grid[i][j] = CellState::Empty;
-            }
-        }
+    if (previewMask.None() && invalidPreviewMask.None()) {
+        return;
     }
+    previewMask = BitBoard();
+    invalidPreviewMask = BitBoard();
+    gridViewDirty = true;
 }
 
-void Grid::Render(Renderer* renderer, int offsetX, int offsetY, const std::string& title, bool isPlayerGrid) const {
-    renderer->RenderGrid(offsetX, offsetY, grid, title, isPlayerGrid);
+int Grid::PlaceShip(int startX, int startY, int shipSize, bool horizontal) {
+    if (shipCount >= MAX_SHIPS) {
+        return NO_SHIP;
+    }
+    
+    int shipId = shipCount++;
+    shipHealth[shipId] = 0;
+    shipCells[shipId] = BitBoard();
+    
+    for (int i = 0; i < shipSize; ++i) {
+        int x = horizontal ? startX + i : startX;
+        int y = horizontal ? startY : startY + i;
+        if (!IsValidPosition(x, y)) continue;
+        
+        SetCell(x, y, CellState::Ship);
+        int index = BitBoard::CellIndex(x, y);
+        shipIds[index] = (int8_t)shipId;
+        shipCells[shipId].Set(index);
+        shipHealth[shipId]++;
+    }
+    return shipId;
+}
+
+ShotResult Grid::ReceiveShot(int x, int y) {
+    CellState cell = GetCell(x, y);
+    if (cell == CellState::Hit || cell == CellState::Miss) {
+        return ShotResult::AlreadyShot;
+    }
+    if (cell != CellState::Ship) {
+        SetCell(x, y, CellState::Miss);
+        return ShotResult::Miss;
+    }
+    
+    SetCell(x, y, CellState::Hit);
+    int shipId = GetShipId(x, y);
+    return (shipId != NO_SHIP && IsShipSunk(shipId)) ? ShotResult::Sunk : ShotResult::Hit;
+}
+
+int Grid::GetShipId(int x, int y) const {
+    if (!IsValidPosition(x, y)) {
+        return NO_SHIP;
+    }
+    return shipIds[BitBoard::CellIndex(x, y)];
 }
 
 int Grid::CountRemainingShips() const {
-    int count = 0;
-    for (int i = 0; i < GRID_SIZE; ++i) {
-        for (int j = 0; j < GRID_SIZE; ++j) {
-            if (grid[i][j] == CellState::Ship) {
-                count++;
+    return shipMask.Count();
+}
+
+const std::array<std::array<CellState, GRID_SIZE>, GRID_SIZE>& Grid::GetGrid() const {
+    if (gridViewDirty) {
+        for (int y = 0; y < GRID_SIZE; ++y) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                gridView[y][x] = GetCell(x, y);
             }
         }
+        gridViewDirty = false;
     }
-    return count;
+    return gridView;
 }
@@ -1,13 +1,8 @@
 #pragma once
 #include <array>
-#include <string>
-#include <SDL3/SDL.h>
+#include <cstdint>
 #include "GameState.h"
-
-class Renderer;
-
-constexpr int GRID_SIZE = 10;
-constexpr int CELL_SIZE = 30;
+#include "BitBoard.h"
 
 class Grid {
 public:
@@ -23,12 +18,44 @@ public:
     
     void ClearPreview();
     
-    void Render(Renderer* renderer, int offsetX, int offsetY, const std::string& title, bool isPlayerGrid = false) const;
-    
     int CountRemainingShips() const;
     
-    const std::array<std::array<CellState, GRID_SIZE>, GRID_SIZE>& GetGrid() const { return grid; }
+    // Ship bookkeeping: every placed ship gets an ID recorded on its cells
+    // and a remaining-hits counter, so sink checks need no board search.
+    static constexpr int MAX_SHIPS = 16;
+    static constexpr int NO_SHIP = -1;
+    
+    int PlaceShip(int startX, int startY, int shipSize, bool horizontal);
+    // A repeated shot changes nothing and reports AlreadyShot, never a hit
+    ShotResult ReceiveShot(int x, int y);
+    
+    int GetShipId(int x, int y) const;
+    int GetShipCount() const { return shipCount; }
+    bool IsShipSunk(int shipId) const { return shipHealth[shipId] == 0; }
+    const BitBoard& GetShipCells(int shipId) const { return shipCells[shipId]; }
+    
+    // Bitboard masks, one bit per cell. A cell is in at most one of them;
+    // cells in none are Empty.
+    const BitBoard& GetShipMask() const { return shipMask; }
+    const BitBoard& GetHitMask() const { return hitMask; }
+    const BitBoard& GetMissMask() const { return missMask; }
+    const BitBoard& GetPreviewMask() const { return previewMask; }
+    
+    // Cell-array view of the masks, rebuilt on demand for rendering
+    const std::array<std::array<CellState, GRID_SIZE>, GRID_SIZE>& GetGrid() const;
 
 private:
-    std::array<std::array<CellState, GRID_SIZE>, GRID_SIZE> grid;
+    BitBoard shipMask;
+    BitBoard hitMask;
+    BitBoard missMask;
+    BitBoard previewMask;
+    BitBoard invalidPreviewMask;
+    
+    std::array<int8_t, GRID_SIZE * GRID_SIZE> shipIds;
+    std::array<int8_t, MAX_SHIPS> shipHealth;
+    std::array<BitBoard, MAX_SHIPS> shipCells;
+    int shipCount;
+    
+    mutable std::array<std::array<CellState, GRID_SIZE>, GRID_SIZE> gridView;
+    mutable bool gridViewDirty;
 };
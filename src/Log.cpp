@@ -0,0 +1,312 @@
+#include "Log.h"
+#include "SpscRing.h"
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Log {
+
+static_assert((int)LogCategory::Count == 5, "give the new category a default level");
+std::array<std::atomic<uint8_t>, (int)LogCategory::Count> categoryLevels = {{
+    {(uint8_t)LogLevel::Info},
+    {(uint8_t)LogLevel::Info},
+    {(uint8_t)LogLevel::Info},
+    {(uint8_t)LogLevel::Info},
+    {(uint8_t)LogLevel::Info},
+}};
+
+namespace {
+
+constexpr size_t RING_CAPACITY = 1024;
+
+const char* GetLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace: return "TRACE";
+        case LogLevel::Debug: return "DEBUG";
+        case LogLevel::Info: return "INFO";
+        case LogLevel::Warn: return "WARN";
+        case LogLevel::Error: return "ERROR";
+        case LogLevel::Off: break;
+    }
+    return "?";
+}
+
+const char* GetCategoryName(LogCategory category) {
+    switch (category) {
+        case LogCategory::General: return "General";
+        case LogCategory::Game: return "Game";
+        case LogCategory::AI: return "AI";
+        case LogCategory::Render: return "Render";
+        case LogCategory::Profiler: return "Profiler";
+        case LogCategory::Count: break;
+    }
+    return "?";
+}
+
+// One per logging thread. The counters let Flush tell when the background
+// thread has caught up without touching the ring itself.
+struct ProducerRing {
+    SpscRing<Record, RING_CAPACITY> ring;
+    std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> written{0};
+    std::atomic<uint64_t> dropped{0};
+    uint64_t droppedReported = 0; // Background thread only
+};
+
+class Logger {
+public:
+    static Logger& Instance() {
+        static Logger logger;
+        return logger;
+    }
+
+    ~Logger() {
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            stopping = true;
+        }
+        wakeups.fetch_add(1, std::memory_order_release);
+        wakeups.notify_one();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    ProducerRing& RingForThisThread() {
+        thread_local std::shared_ptr<ProducerRing> ring;
+        if (!ring) {
+            ring = std::make_shared<ProducerRing>();
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            rings.push_back(ring);
+            // Started on first use so programs that never log never pay for it
+            if (!worker.joinable()) {
+                worker = std::thread(&Logger::Run, this);
+            }
+        }
+        return *ring;
+    }
+
+    uint64_t NowNs() const {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+            .count();
+    }
+
+    void Flush() {
+        std::vector<std::pair<std::shared_ptr<ProducerRing>, uint64_t>> targets;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            for (const auto& ring : rings) {
+                targets.push_back({ring, ring->submitted.load(std::memory_order_acquire)});
+            }
+        }
+        for (const auto& [ring, submitted] : targets) {
+            while (ring->written.load(std::memory_order_acquire) < submitted) {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
+        }
+    }
+
+    // Called after a record is queued. Only a caller that finds the
+    // background thread asleep pays for waking it.
+    void Wake() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleeping.load(std::memory_order_relaxed) && sleeping.exchange(false, std::memory_order_relaxed)) {
+            wakeups.fetch_add(1, std::memory_order_release);
+            wakeups.notify_one();
+        }
+    }
+
+    std::atomic<bool> showMetadata{false};
+
+private:
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<ProducerRing>> rings; // Only ever grows
+    std::thread worker;
+    bool stopping = false;
+    std::atomic<bool> sleeping{false}; // The background thread is blocked, or about to
+    std::atomic<uint32_t> wakeups{0};
+
+    std::string outBuffer;
+    std::string errBuffer;
+
+    // While records keep coming they are polled every 2 ms, so callers don't
+    // pay a system call each; once a poll finds nothing the thread blocks
+    // until a caller wakes it.
+    void Run() {
+        while (true) {
+            uint32_t seen = wakeups.load(std::memory_order_acquire);
+            bool stop;
+            {
+                std::lock_guard<std::mutex> lock(ringsMutex);
+                stop = stopping;
+            }
+            if (Drain()) {
+                if (!stop) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+                continue;
+            }
+            if (stop) return;
+
+            sleeping.store(true, std::memory_order_relaxed);
+            // Pairs with the fence in Wake: either that caller sees us asleep,
+            // or we see its record here
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (AnyQueued()) {
+                sleeping.store(false, std::memory_order_relaxed);
+                continue;
+            }
+            wakeups.wait(seen, std::memory_order_acquire);
+            sleeping.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    bool AnyQueued() {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const auto& producer : rings) {
+            if (producer->submitted.load(std::memory_order_acquire) != producer->written.load(std::memory_order_relaxed) ||
+                producer->dropped.load(std::memory_order_relaxed) != producer->droppedReported) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Formats and writes everything queued; false if there was nothing.
+    // Lines from different threads are not merged by time.
+    bool Drain() {
+        std::vector<std::shared_ptr<ProducerRing>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(ringsMutex);
+            snapshot = rings;
+        }
+
+        bool any = false;
+        for (const auto& producer : snapshot) {
+            uint64_t popped = 0;
+            Record record;
+            while (producer->ring.TryPop(record)) {
+                Format(record, record.level >= LogLevel::Warn ? errBuffer : outBuffer);
+                popped++;
+            }
+            uint64_t dropped = producer->dropped.load(std::memory_order_relaxed);
+            if (dropped != producer->droppedReported) {
+                errBuffer += "Log: " + std::to_string(dropped - producer->droppedReported) +
+                             " records dropped, ring full\n";
+                producer->droppedReported = dropped;
+            }
+            if (popped == 0 && outBuffer.empty() && errBuffer.empty()) continue;
+
+            WriteBuffers();
+            producer->written.fetch_add(popped, std::memory_order_release);
+            any = true;
+        }
+        return any;
+    }
+
+    void WriteBuffers() {
+        if (!outBuffer.empty()) {
+            std::fwrite(outBuffer.data(), 1, outBuffer.size(), stdout);
+            std::fflush(stdout);
+            outBuffer.clear();
+        }
+        if (!errBuffer.empty()) {
+            std::fwrite(errBuffer.data(), 1, errBuffer.size(), stderr);
+            std::fflush(stderr);
+            errBuffer.clear();
+        }
+    }
+
+    void Format(const Record& record, std::string& out) const {
+        if (record.showMetadata) {
+            char prefix[64];
+            std::snprintf(prefix, sizeof(prefix), "%10.3f %-8s %-5s ", record.timestampNs / 1e9,
+                          GetCategoryName(record.category), GetLevelName(record.level));
+            out += prefix;
+        }
+
+        int nextArg = 0;
+        for (const char* c = record.format; *c; ++c) {
+            if (c[0] == '{' && c[1] == '}') {
+                if (nextArg < record.argCount) {
+                    AppendArg(record, record.args[nextArg++], out);
+                }
+                ++c;
+            } else if ((c[0] == '{' && c[1] == '{') || (c[0] == '}' && c[1] == '}')) {
+                out += *c++;
+            } else {
+                out += *c;
+            }
+        }
+        out += '\n';
+    }
+
+    static void AppendArg(const Record& record, const Arg& arg, std::string& out) {
+        char buffer[32];
+        switch (arg.type) {
+            case Arg::Type::Signed: {
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), arg.signedValue);
+                out.append(buffer, result.ptr);
+                break;
+            }
+            case Arg::Type::Unsigned: {
+                auto result = std::to_chars(buffer, buffer + sizeof(buffer), arg.unsignedValue);
+                out.append(buffer, result.ptr);
+                break;
+            }
+            case Arg::Type::Double:
+                // Same as an ostream's default formatting
+                out.append(buffer, std::snprintf(buffer, sizeof(buffer), "%g", arg.doubleValue));
+                break;
+            case Arg::Type::Char:
+                out += arg.charValue;
+                break;
+            case Arg::Type::Bool:
+                out += arg.boolValue ? "true" : "false";
+                break;
+            case Arg::Type::String:
+                out.append(record.text.data() + arg.text.offset, arg.text.length);
+                break;
+        }
+    }
+};
+
+} // namespace
+
+void SetLevel(LogLevel level) {
+    for (auto& categoryLevel : categoryLevels) {
+        categoryLevel.store((uint8_t)level, std::memory_order_relaxed);
+    }
+}
+
+void SetCategoryLevel(LogCategory category, LogLevel level) {
+    categoryLevels[(int)category].store((uint8_t)level, std::memory_order_relaxed);
+}
+
+void SetShowMetadata(bool enabled) {
+    Logger::Instance().showMetadata.store(enabled, std::memory_order_relaxed);
+}
+
+void Flush() {
+    Logger::Instance().Flush();
+}
+
+void Submit(Record& record) {
+    Logger& logger = Logger::Instance();
+    ProducerRing& producer = logger.RingForThisThread();
+    record.timestampNs = logger.NowNs();
+    record.showMetadata = logger.showMetadata.load(std::memory_order_relaxed);
+    if (producer.ring.TryPush(record)) {
+        producer.submitted.fetch_add(1, std::memory_order_release);
+    } else {
+        producer.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    logger.Wake();
+}
+
+} // namespace Log
@@ -0,0 +1,171 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// Asynchronous logging. Callers copy the format string pointer and their
+// arguments into a fixed-size record on a per-thread lock-free ring; a
+// background thread formats the records and writes them out, Info and below
+// to stdout and Warn and above to stderr. A full ring drops records rather
+// than stall the caller.
+//
+//     LOG_INFO(LogCategory::Game, "HIT at {}{}!", column, row);
+//
+// The format must be a string literal; each {} takes the next argument.
+// String arguments are copied into TEXT_CAPACITY bytes per record; one
+// that doesn't fit is cut short and ends in "...".
+// Levels under BATTLESHIP_LOG_MIN_LEVEL compile to nothing, arguments
+// included; the rest cost one relaxed load when disabled at run time.
+
+enum class LogLevel : uint8_t {
+    Trace,
+    Debug,
+    Info,
+    Warn,
+    Error,
+    Off,
+};
+
+enum class LogCategory : uint8_t {
+    General,
+    Game,
+    AI,
+    Render,
+    Profiler,
+    Count
+};
+
+#ifndef BATTLESHIP_LOG_MIN_LEVEL
+#define BATTLESHIP_LOG_MIN_LEVEL 0 // LogLevel::Trace
+#endif
+
+namespace Log {
+
+constexpr LogLevel MIN_LEVEL = (LogLevel)BATTLESHIP_LOG_MIN_LEVEL;
+constexpr int MAX_ARGS = 6;
+constexpr int TEXT_CAPACITY = 256; // Bytes shared by a record's string arguments
+
+struct Arg {
+    enum class Type : uint8_t { Signed, Unsigned, Double, Char, Bool, String };
+    Type type;
+    union {
+        int64_t signedValue;
+        uint64_t unsignedValue;
+        double doubleValue;
+        char charValue;
+        bool boolValue;
+        struct {
+            uint16_t offset;
+            uint16_t length;
+        } text;
+    };
+};
+
+struct Record {
+    const char* format;
+    uint64_t timestampNs;
+    LogLevel level;
+    LogCategory category;
+    uint8_t argCount;
+    uint16_t textLength;
+    bool showMetadata;
+    std::array<Arg, MAX_ARGS> args;
+    std::array<char, TEXT_CAPACITY> text;
+};
+
+// Minimum level per category, read on every call
+extern std::array<std::atomic<uint8_t>, (int)LogCategory::Count> categoryLevels;
+
+inline bool IsEnabled(LogLevel level, LogCategory category) {
+    return (uint8_t)level >= categoryLevels[(int)category].load(std::memory_order_relaxed);
+}
+
+void SetLevel(LogLevel level); // Every category
+void SetCategoryLevel(LogCategory category, LogLevel level);
+
+// Prefix lines with time, category and level; off by default so the console
+// reads like plain output
+void SetShowMetadata(bool enabled);
+
+// Blocks until everything logged so far has been written
+void Flush();
+
+void Submit(Record& record); // Stamps the record and queues it
+
+inline void CaptureText(Record& record, std::string_view value) {
+    constexpr std::string_view TRUNCATED = "...";
+    Arg& arg = record.args[record.argCount++];
+    size_t room = TEXT_CAPACITY - record.textLength;
+    char* out = record.text.data() + record.textLength;
+    size_t length = value.copy(out, room);
+    if (length < value.size()) {
+        // Out of room: end with a marker so the cut shows in the output
+        size_t marker = std::min(room, TRUNCATED.size());
+        TRUNCATED.copy(out + room - marker, marker);
+    }
+    arg.type = Arg::Type::String;
+    arg.text = {record.textLength, (uint16_t)length};
+    record.textLength = (uint16_t)(record.textLength + length);
+}
+
+template <typename T>
+void Capture(Record& record, const T& value) {
+    if constexpr (std::is_same_v<T, bool>) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Bool;
+        arg.boolValue = value;
+    } else if constexpr (std::is_same_v<T, char>) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Char;
+        arg.charValue = value;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Signed;
+        arg.signedValue = value;
+    } else if constexpr (std::is_integral_v<T>) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Unsigned;
+        arg.unsignedValue = value;
+    } else if constexpr (std::is_floating_point_v<T>) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Double;
+        arg.doubleValue = value;
+    } else {
+        // Strings are copied: the caller's buffer may be gone by format time
+        CaptureText(record, std::string_view(value));
+    }
+}
+
+template <typename... Args>
+void Write(LogLevel level, LogCategory category, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "too many log arguments");
+    Record record;
+    record.format = format;
+    record.level = level;
+    record.category = category;
+    record.argCount = 0;
+    record.textLength = 0;
+    (Capture(record, args), ...);
+    Submit(record);
+}
+
+} // namespace Log
+
+#define BATTLESHIP_LOG(level, category, ...)                                      \
+    do {                                                                          \
+        if constexpr ((level) >= Log::MIN_LEVEL) {                                \
+            if (Log::IsEnabled(level, category)) {                                \
+                Log::Write(level, category, __VA_ARGS__);                         \
+            }                                                                     \
+        }                                                                         \
+    } while (false)
+
+#define LOG_TRACE(category, ...) BATTLESHIP_LOG(LogLevel::Trace, category, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) BATTLESHIP_LOG(LogLevel::Debug, category, __VA_ARGS__)
+#define LOG_INFO(category, ...) BATTLESHIP_LOG(LogLevel::Info, category, __VA_ARGS__)
+#define LOG_WARN(category, ...) BATTLESHIP_LOG(LogLevel::Warn, category, __VA_ARGS__)
+#define LOG_ERROR(category, ...) BATTLESHIP_LOG(LogLevel::Error, category, __VA_ARGS__)
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Read-only memory mapping of a whole file. Large archives are paged in by
+// the OS as they are touched, so nothing is copied or read up front.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Maps the file, replacing any previous mapping; false with an error message on failure
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    bool IsOpen() const { return opened; }
+    std::span<const uint8_t> GetBytes() const { return {data, size}; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool opened = false;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
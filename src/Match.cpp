@@ -0,0 +1,117 @@
+#include "Match.h"
+#include "Ship.h"
+#include <cassert>
+
+Match::Match() {
+    Reset();
+}
+
+void Match::Reset() {
+    gameState.Reset();
+    for (Grid& grid : grids) {
+        grid.Reset();
+    }
+    shotCounts.fill(0);
+    winner = Side::Player;
+}
+
+bool Match::CanPlaceShip(Side side, int x, int y, int size, bool horizontal) const {
+    return gameState.GetState() == GameStateType::ShipPlacement &&
+           ShipManager::IsValidPlacement(GetGrid(side), x, y, size, horizontal);
+}
+
+bool Match::PlaceShip(Side side, int x, int y, int size, bool horizontal) {
+    if (!CanPlaceShip(side, x, y, size, horizontal)) {
+        return false;
+    }
+    return GetGrid(side).PlaceShip(x, y, size, horizontal) != Grid::NO_SHIP;
+}
+
+bool Match::PlaceFleet(Side side, std::span<const ShipPlacement> placements) {
+    for (const ShipPlacement& placement : placements) {
+        if (!PlaceShip(side, placement.x, placement.y, placement.size, placement.horizontal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Match::PlaceFleetRandomly(Side side, std::span<const int> shipSizes, std::mt19937& rng) {
+    std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+    if (shipSizes.size() > placements.size()) {
+        return false;
+    }
+    
+    std::span<ShipPlacement> layout(placements.data(), shipSizes.size());
+    const Grid& grid = GetGrid(side);
+    if (!GenerateRandomFleet(shipSizes, rng, layout, grid.GetShipMask(), grid.GetHitMask() | grid.GetMissMask())) {
+        return false;
+    }
+    return PlaceFleet(side, layout);
+}
+
+void Match::StartBattle(Side firstToMove) {
+    const Grid& playerGrid = GetGrid(Side::Player);
+    const Grid& aiGrid = GetGrid(Side::AI);
+    gameState.InitializeFleets(playerGrid.GetShipCount(), playerGrid.CountRemainingShips(),
+                               aiGrid.GetShipCount(), aiGrid.CountRemainingShips());
+    gameState.SetPlayerTurn(firstToMove == Side::Player);
+    gameState.SetState(GameStateType::Battle);
+}
+
+Side Match::GetSideToMove() const {
+    return gameState.IsPlayerTurn() ? Side::Player : Side::AI;
+}
+
+bool Match::CanFire(int x, int y) const {
+    if (gameState.GetState() != GameStateType::Battle || gameState.IsGameEnded()) {
+        return false;
+    }
+    const Grid& target = GetGrid(OpposingSide(GetSideToMove()));
+    if (!target.IsValidPosition(x, y)) {
+        return false;
+    }
+    CellState cell = target.GetCell(x, y);
+    return cell != CellState::Hit && cell != CellState::Miss;
+}
+
+bool Match::Fire(int x, int y, ShotOutcome& outcome) {
+    if (!CanFire(x, y)) {
+        return false;
+    }
+    
+    Side shooter = GetSideToMove();
+    Side defender = OpposingSide(shooter);
+    Grid& target = GetGrid(defender);
+    outcome.result = target.ReceiveShot(x, y);
+    assert(outcome.result != ShotResult::AlreadyShot); // CanFire rules repeated shots out
+    outcome.shipId = outcome.result == ShotResult::Miss ? Grid::NO_SHIP : target.GetShipId(x, y);
+    shotCounts[(int)shooter]++;
+    
+    if (outcome.result != ShotResult::Miss) {
+        bool sunk = outcome.result == ShotResult::Sunk;
+        if (defender == Side::Player) {
+            gameState.RegisterPlayerShipHit(sunk);
+        } else {
+            gameState.RegisterAIShipHit(sunk);
+        }
+    }
+    
+    outcome.matchOver = GetCellsRemaining(defender) == 0;
+    if (outcome.matchOver) {
+        winner = shooter;
+        gameState.SetGameEnded(true);
+        gameState.SetState(GameStateType::GameOver);
+    } else {
+        gameState.SetPlayerTurn(defender == Side::Player);
+    }
+    return true;
+}
+
+int Match::GetShipsRemaining(Side side) const {
+    return side == Side::Player ? gameState.GetPlayerShipsRemaining() : gameState.GetAIShipsRemaining();
+}
+
+int Match::GetCellsRemaining(Side side) const {
+    return side == Side::Player ? gameState.GetPlayerCellsRemaining() : gameState.GetAICellsRemaining();
+}
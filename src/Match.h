@@ -0,0 +1,62 @@
+#pragma once
+#include <array>
+#include <random>
+#include <span>
+#include "GameState.h"
+#include "Grid.h"
+#include "FleetGenerator.h"
+
+enum class Side {
+    Player = 0,
+    AI = 1,
+};
+
+constexpr Side OpposingSide(Side side) {
+    return side == Side::Player ? Side::AI : Side::Player;
+}
+
+// Result of one accepted shot
+struct ShotOutcome {
+    ShotResult result;
+    int shipId;     // Ship hit on the target grid, Grid::NO_SHIP on a miss
+    bool matchOver; // The shot sank the last ship
+};
+
+// Headless game rules shared by the SDL front end, tools and simulations:
+// two boards, fleet placement, alternating shots and fleet bookkeeping.
+class Match {
+public:
+    Match();
+    
+    // Empty boards, back to the placement phase
+    void Reset();
+    
+    // Placement phase
+    bool CanPlaceShip(Side side, int x, int y, int size, bool horizontal) const;
+    bool PlaceShip(Side side, int x, int y, int size, bool horizontal);
+    bool PlaceFleet(Side side, std::span<const ShipPlacement> placements);
+    bool PlaceFleetRandomly(Side side, std::span<const int> shipSizes, std::mt19937& rng);
+    void StartBattle(Side firstToMove = Side::Player);
+    
+    // Battle phase; the side to move fires at the other side's grid
+    Side GetSideToMove() const;
+    bool CanFire(int x, int y) const;
+    bool Fire(int x, int y, ShotOutcome& outcome);
+    
+    bool IsOver() const { return gameState.IsGameEnded(); }
+    Side GetWinner() const { return winner; }
+    int GetShotCount(Side side) const { return shotCounts[(int)side]; }
+    int GetShipsRemaining(Side side) const;
+    int GetCellsRemaining(Side side) const;
+    
+    const Grid& GetGrid(Side side) const { return grids[(int)side]; }
+    Grid& GetGrid(Side side) { return grids[(int)side]; }
+    const GameState& GetGameState() const { return gameState; }
+    GameState& GetGameState() { return gameState; }
+
+private:
+    GameState gameState;
+    std::array<Grid, 2> grids;
+    std::array<int, 2> shotCounts;
+    Side winner;
+};
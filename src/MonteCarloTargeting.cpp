@@ -0,0 +1,189 @@
+#include "MonteCarloTargeting.h"
+#include "FleetGenerator.h"
+#include "PlacementTable.h"
+#include <algorithm>
+
+MonteCarloTargeting::MonteCarloTargeting(int threadCount) {
+    if (threadCount <= 0) {
+        threadCount = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    results.resize(threadCount);
+
+    std::random_device rd;
+    for (int i = 0; i < threadCount; ++i) {
+        std::seed_seq seed{rd(), rd(), (unsigned)i};
+        workerRngs.emplace_back(seed);
+    }
+
+    // Worker 0 is whichever thread calls ChooseTarget
+    for (int i = 1; i < threadCount; ++i) {
+        workers.emplace_back(&MonteCarloTargeting::WorkerLoop, this, i);
+    }
+}
+
+MonteCarloTargeting::~MonteCarloTargeting() {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopping = true;
+    }
+    jobReady.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void MonteCarloTargeting::WorkerLoop(int index) {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(jobMutex);
+            jobReady.wait(lock, [&] { return stopping || jobGeneration != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = jobGeneration;
+        }
+
+        SampleLayouts(index);
+        if (workersBusy.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            workersBusy.notify_one();
+        }
+    }
+}
+
+// Draws layouts of the afloat ships around the sunk ones and off the misses,
+// keeping those that cover every open hit; adds to the worker's tallies
+void MonteCarloTargeting::SampleLayouts(int index) {
+    WorkerResult& result = results[index];
+    std::mt19937& rng = workerRngs[index];
+
+    std::array<int, MAX_FLEET_SIZE> sizes;
+    int shipCount = 0;
+    for (int size = MAX_SHIP_SIZE; size >= 1; --size) {
+        for (int i = 0; i < jobView.remainingShips[size] && shipCount < MAX_FLEET_SIZE; ++i) {
+            sizes[shipCount++] = size;
+        }
+    }
+    if (shipCount == 0) return;
+
+    // Every legal spot of the last (smallest) ship is tallied instead of one
+    // drawn at random, which takes most of the noise out of the weights
+    int lastSize = sizes[shipCount - 1];
+    std::span<const int> fleet(sizes.data(), shipCount - 1);
+    std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+    std::span<ShipPlacement> layout(placements.data(), shipCount - 1);
+
+    // An attempt takes about a microsecond, far more than reading the clock
+    while (std::chrono::steady_clock::now() < jobDeadline) {
+        result.attempts++;
+        double weight = SampleWeightedFleet(fleet, rng, layout, jobView.sunkCells, jobView.misses);
+        if (weight == 0.0) continue;
+
+        BitBoard shipCells;
+        BitBoard blocked = jobView.misses | jobView.sunkCells.Dilate();
+        for (const ShipPlacement& placement : layout) {
+            const PlacementMasks& masks = GetPlacementMasks(placement.size, placement.horizontal, placement.x, placement.y);
+            shipCells |= masks.footprint;
+            blocked |= masks.halo;
+        }
+        // The last ship has to cover whatever hits the others left uncovered
+        BitBoard uncovered = jobView.openHits & ~shipCells;
+        AnchorSet anchors = ComputeAnchors(BOARD_MASK & ~blocked, lastSize);
+        int completions = 0;
+        for (int orientation = 0; orientation < 2; ++orientation) {
+            BitBoard remaining = orientation == 0 ? anchors.horizontal : anchors.vertical;
+            while (remaining.Any()) {
+                const PlacementMasks& masks = PLACEMENT_TABLE[lastSize][orientation][remaining.PopLowest()];
+                if ((uncovered & ~masks.footprint).Any()) continue;
+                completions++;
+                for (BitBoard cells = masks.footprint; cells.Any();) {
+                    result.shipWeights[cells.PopLowest()] += weight;
+                }
+            }
+        }
+        if (completions == 0) continue;
+
+        result.samples++;
+        while (shipCells.Any()) {
+            result.shipWeights[shipCells.PopLowest()] += weight * completions;
+        }
+    }
+}
+
+// Samples on every worker until the deadline
+void MonteCarloTargeting::RunRound(std::chrono::steady_clock::time_point deadline) {
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobDeadline = deadline;
+        workersBusy.store((int)workers.size(), std::memory_order_relaxed);
+        jobGeneration++;
+    }
+    jobReady.notify_all();
+
+    SampleLayouts(0);
+    for (int busy = workersBusy.load(std::memory_order_acquire); busy != 0;
+         busy = workersBusy.load(std::memory_order_acquire)) {
+        workersBusy.wait(busy, std::memory_order_acquire);
+    }
+}
+
+int MonteCarloTargeting::ChooseTarget(const TargetingView& view, std::mt19937& rng, SearchObserver* observer) {
+    BitBoard unshot = BOARD_MASK & ~(view.openHits | view.misses | view.sunkCells);
+    if (unshot.None()) {
+        return -1;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobView = view;
+    }
+    for (WorkerResult& result : results) {
+        result.shipWeights.fill(0.0);
+        result.samples = 0;
+        result.attempts = 0;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeBudget;
+    std::array<double, GRID_SIZE * GRID_SIZE> shipWeights;
+    while (true) {
+        auto now = std::chrono::steady_clock::now();
+        RunRound(observer ? std::min(deadline, now + REPORT_INTERVAL) : deadline);
+
+        shipWeights.fill(0.0);
+        lastSamples = 0;
+        lastAttempts = 0;
+        for (const WorkerResult& result : results) {
+            for (int cell = 0; cell < GRID_SIZE * GRID_SIZE; ++cell) {
+                shipWeights[cell] += result.shipWeights[cell];
+            }
+            lastSamples += result.samples;
+            lastAttempts += result.attempts;
+        }
+        if (!observer || std::chrono::steady_clock::now() >= deadline) break;
+        if (lastSamples > 0) observer->OnBestSoFar(BestCell(shipWeights, unshot, nullptr));
+        if (observer->ShouldStop()) break;
+    }
+
+    if (lastSamples == 0) {
+        return ChooseDensityTarget(view, rng);
+    }
+    return BestCell(shipWeights, unshot, &rng);
+}
+
+int MonteCarloTargeting::BestCell(const std::array<double, GRID_SIZE * GRID_SIZE>& shipWeights, BitBoard unshot,
+                                  std::mt19937* rng) {
+    double best = 0.0;
+    BitBoard ties;
+    while (unshot.Any()) {
+        int cell = unshot.PopLowest();
+        if (ties.None() || shipWeights[cell] > best) {
+            best = shipWeights[cell];
+            ties = BitBoard::Cell(cell);
+        } else if (shipWeights[cell] == best) {
+            ties.Set(cell);
+        }
+    }
+    if (!rng) {
+        return ties.LowestIndex();
+    }
+    int pick = std::uniform_int_distribution<int>(0, ties.Count() - 1)(*rng);
+    return ties.NthIndex(pick);
+}
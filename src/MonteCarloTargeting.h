@@ -0,0 +1,79 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "DensityTargeting.h"
+
+// "Hard" targeting: samples complete opponent layouts consistent with a
+// TargetingView until a time budget runs out, then fires at the unshot cell
+// most likely to hold a ship. Layouts come from SampleWeightedFleet and count
+// with its weight, so the tallies estimate the odds over all consistent
+// layouts rather than the sampler's own preferences. A persistent pool shares the sampling;
+// the calling thread works as worker 0. Each worker has its own RNG and
+// histogram, and the histograms are only summed once every worker is done.
+// With an observer the budget is spent in rounds of REPORT_INTERVAL, and the
+// argmax of the histograms summed so far is reported after each.
+class MonteCarloTargeting {
+public:
+    // threadCount 0 uses every hardware thread
+    explicit MonteCarloTargeting(int threadCount = 0);
+    ~MonteCarloTargeting();
+
+    MonteCarloTargeting(const MonteCarloTargeting&) = delete;
+    MonteCarloTargeting& operator=(const MonteCarloTargeting&) = delete;
+
+    // Unshot cell to fire at, or -1 if every cell was shot. Falls back to the
+    // density heuristic if no consistent layout was sampled within the budget.
+    // observer may be null; stopping it ends the search after the current round.
+    int ChooseTarget(const TargetingView& view, std::mt19937& rng, SearchObserver* observer = nullptr);
+
+    void SetTimeBudget(std::chrono::microseconds budget) { timeBudget = budget; }
+    std::chrono::microseconds GetTimeBudget() const { return timeBudget; }
+    int GetThreadCount() const { return (int)results.size(); }
+
+    // Statistics of the last ChooseTarget call
+    uint64_t GetLastSampleCount() const { return lastSamples; }
+    uint64_t GetLastAttemptCount() const { return lastAttempts; }
+
+private:
+    // Short enough to stop promptly, long enough that waking the pool stays cheap
+    static constexpr std::chrono::microseconds REPORT_INTERVAL{1000};
+
+    // One cache line per worker so workers never write to a shared line
+    struct alignas(64) WorkerResult {
+        std::array<double, GRID_SIZE * GRID_SIZE> shipWeights;
+        uint64_t samples;
+        uint64_t attempts;
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<WorkerResult> results;
+    std::vector<std::mt19937> workerRngs;
+
+    std::mutex jobMutex;
+    std::condition_variable jobReady;
+    uint64_t jobGeneration = 0;
+    bool stopping = false;
+    std::atomic<int> workersBusy{0};
+
+    // Current job, written before jobGeneration is bumped
+    TargetingView jobView;
+    std::chrono::steady_clock::time_point jobDeadline;
+
+    std::chrono::microseconds timeBudget{5000};
+    uint64_t lastSamples = 0;
+    uint64_t lastAttempts = 0;
+
+    void WorkerLoop(int index);
+    void RunRound(std::chrono::steady_clock::time_point deadline);
+    void SampleLayouts(int index);
+    // Unshot cell with the most weight; ties go to rng, or to the lowest cell without one
+    static int BestCell(const std::array<double, GRID_SIZE * GRID_SIZE>& shipWeights, BitBoard unshot,
+                        std::mt19937* rng);
+};
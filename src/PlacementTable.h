@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include "BitBoard.h"
+
+constexpr int MAX_SHIP_SIZE = 5;
+
+// Precomputed masks for one ship placement
+struct PlacementMasks {
+    BitBoard footprint; // Cells covered by the ship
+    BitBoard halo;      // Footprint plus all 8-neighbours (no touching rule)
+    bool inBounds;      // False if the ship would stick out of the board
+};
+
+// Indexed by [shipSize][horizontal ? 0 : 1][anchor cell index]
+using PlacementTable = std::array<std::array<std::array<PlacementMasks, GRID_SIZE * GRID_SIZE>, 2>, MAX_SHIP_SIZE + 1>;
+
+constexpr PlacementTable BuildPlacementTable() {
+    PlacementTable table{};
+    for (int size = 1; size <= MAX_SHIP_SIZE; ++size) {
+        for (int orientation = 0; orientation < 2; ++orientation) {
+            bool horizontal = orientation == 0;
+            for (int y = 0; y < GRID_SIZE; ++y) {
+                for (int x = 0; x < GRID_SIZE; ++x) {
+                    PlacementMasks& masks = table[size][orientation][BitBoard::CellIndex(x, y)];
+                    masks.inBounds = horizontal ? x + size <= GRID_SIZE : y + size <= GRID_SIZE;
+                    if (!masks.inBounds) continue;
+                    
+                    for (int i = 0; i < size; ++i) {
+                        masks.footprint.Set(horizontal ? BitBoard::CellIndex(x + i, y) : BitBoard::CellIndex(x, y + i));
+                    }
+                    masks.halo = masks.footprint.Dilate();
+                }
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr PlacementTable PLACEMENT_TABLE = BuildPlacementTable();
+
+// Caller guarantees 1 <= shipSize <= MAX_SHIP_SIZE and (x, y) on the board
+constexpr const PlacementMasks& GetPlacementMasks(int shipSize, bool horizontal, int x, int y) {
+    return PLACEMENT_TABLE[shipSize][horizontal ? 0 : 1][BitBoard::CellIndex(x, y)];
+}
+
+// Legal anchors of one ship, split by orientation
+struct AnchorSet {
+    BitBoard horizontal;
+    BitBoard vertical;
+};
+
+// All anchors where a ship of the given size fits entirely on free cells.
+// A horizontal anchor needs the next size-1 cells to its right free as well;
+// West() only keeps bits whose eastern neighbour is in the same row.
+constexpr AnchorSet ComputeAnchors(const BitBoard& freeCells, int size) {
+    AnchorSet anchors{freeCells, freeCells};
+    BitBoard east = freeCells;
+    BitBoard south = freeCells;
+    for (int i = 1; i < size; ++i) {
+        east = east.West();
+        south = south.North();
+        anchors.horizontal &= east;
+        anchors.vertical &= south;
+    }
+    return anchors;
+}
+
+static_assert(GetPlacementMasks(5, true, 5, 0).inBounds && !GetPlacementMasks(5, true, 6, 0).inBounds);
+static_assert(GetPlacementMasks(2, false, 0, 0).halo.Count() == 6);
+static_assert(ComputeAnchors(BOARD_MASK, 5).horizontal.Count() == 60);
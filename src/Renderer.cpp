@@ -1,5 +1,6 @@
 #include "Renderer.h"
 #include "Ship.h"
+#include "Log.h"
 #include <array>
 
 constexpr int WINDOW_WIDTH = 800;
@@ -8,63 +9,200 @@ constexpr int GRID_MARGIN = 50;
 constexpr int GRID_SPACING = 50;
 constexpr int CELL_SIZE = 30;
 
-Renderer::Renderer(SDL_Renderer* sdlRenderer) : renderer(sdlRenderer) {
+Renderer::Renderer(SDL_Renderer* sdlRenderer) 
+    : renderer(sdlRenderer), fontAtlas(nullptr), drawCallCount(0), lastFrameDrawCallCount(0) {
+    glyphHasPixels.fill(false);
+    BuildFontAtlas();
+    BuildGridIndices();
+}
+
+Renderer::~Renderer() {
+    if (fontAtlas) {
+        SDL_DestroyTexture(fontAtlas);
+        fontAtlas = nullptr;
+    }
 }
 
 void Renderer::RenderGrid(int offsetX, int offsetY, const std::array<std::array<CellState, 10>, 10>& grid, 
                          const std::string& title, bool isPlayerGrid) const {
-    // Render title
-    RenderText(title, offsetX + (10 * CELL_SIZE) / 2 - 50, offsetY - 25);
-    
-    // Render grid cells
+    // Build one quad per cell with the cell colour on every vertex
+    gridVertices.clear();
     for (int row = 0; row < 10; ++row) {
         for (int col = 0; col < 10; ++col) {
-            SDL_FRect cellRect = {
-                (float)(offsetX + col * CELL_SIZE),
-                (float)(offsetY + row * CELL_SIZE),
-                (float)CELL_SIZE,
-                (float)CELL_SIZE
-            };
-            
-            // Fill cell with appropriate color
             SDL_Color cellColor = GetCellColor(grid[row][col], isPlayerGrid);
-            SDL_SetRenderDrawColor(renderer, cellColor.r, cellColor.g, cellColor.b, cellColor.a);
-            SDL_RenderFillRect(renderer, &cellRect);
+            SDL_FColor color = {cellColor.r / 255.0f, cellColor.g / 255.0f, cellColor.b / 255.0f, cellColor.a / 255.0f};
             
-            // Draw cell border
-            SDL_SetRenderDrawColor(renderer, gridLineColor.r, gridLineColor.g, gridLineColor.b, gridLineColor.a);
-            SDL_RenderRect(renderer, &cellRect);
+            float left = (float)(offsetX + col * CELL_SIZE);
+            float top = (float)(offsetY + row * CELL_SIZE);
+            float right = left + CELL_SIZE;
+            float bottom = top + CELL_SIZE;
+            
+            gridVertices.push_back({{left, top}, color, {0.0f, 0.0f}});
+            gridVertices.push_back({{right, top}, color, {0.0f, 0.0f}});
+            gridVertices.push_back({{right, bottom}, color, {0.0f, 0.0f}});
+            gridVertices.push_back({{left, bottom}, color, {0.0f, 0.0f}});
         }
     }
     
-    // Render grid labels
+    // Fill all cells with a single call
+    SDL_RenderGeometry(renderer, nullptr, gridVertices.data(), (int)gridVertices.size(),
+                       gridIndices.data(), (int)gridIndices.size());
+    drawCallCount++;
+    
+    // Draw all grid lines as one polyline: snake through the horizontal lines,
+    // then back through the vertical ones. Each turn runs along the outer border,
+    // which is a grid line itself, so no extra segments appear.
+    float left = (float)offsetX;
+    float top = (float)offsetY;
+    float right = (float)(offsetX + 10 * CELL_SIZE);
+    float bottom = (float)(offsetY + 10 * CELL_SIZE);
+    
+    gridLinePoints.clear();
+    for (int row = 0; row <= 10; ++row) {
+        float y = (float)(offsetY + row * CELL_SIZE);
+        if (row % 2 == 0) {
+            gridLinePoints.push_back({left, y});
+            gridLinePoints.push_back({right, y});
+        } else {
+            gridLinePoints.push_back({right, y});
+            gridLinePoints.push_back({left, y});
+        }
+    }
+    for (int col = 10; col >= 0; --col) {
+        float x = (float)(offsetX + col * CELL_SIZE);
+        if ((10 - col) % 2 == 0) {
+            gridLinePoints.push_back({x, bottom});
+            gridLinePoints.push_back({x, top});
+        } else {
+            gridLinePoints.push_back({x, top});
+            gridLinePoints.push_back({x, bottom});
+        }
+    }
+    
+    SDL_SetRenderDrawColor(renderer, gridLineColor.r, gridLineColor.g, gridLineColor.b, gridLineColor.a);
+    SDL_RenderLines(renderer, gridLinePoints.data(), (int)gridLinePoints.size());
+    drawCallCount++;
+    
+    // Render title and grid labels as one text batch
+    textVertices.clear();
+    textIndices.clear();
+    AppendText(title, offsetX + (10 * CELL_SIZE) / 2 - 50, offsetY - 25, 1);
     RenderGridLabels(offsetX, offsetY);
+    FlushText();
 }
 
 void Renderer::RenderGridLabels(int offsetX, int offsetY) const {
     // Column labels (A-J)
     for (int col = 0; col < 10; ++col) {
         std::string label = std::string(1, 'A' + col);
-        RenderText(label, offsetX + col * CELL_SIZE + CELL_SIZE / 2 - 5, offsetY - 15);
+        AppendText(label, offsetX + col * CELL_SIZE + CELL_SIZE / 2 - 5, offsetY - 15, 1);
     }
     
     // Row labels (1-10)
     for (int row = 0; row < 10; ++row) {
         std::string label = std::to_string(row + 1);
-        RenderText(label, offsetX - 20, offsetY + row * CELL_SIZE + CELL_SIZE / 2 - 5);
+        AppendText(label, offsetX - 20, offsetY + row * CELL_SIZE + CELL_SIZE / 2 - 5, 1);
     }
 }
 
 void Renderer::RenderText(const std::string& text, int x, int y) const {
-    for (size_t i = 0; i < text.length(); ++i) {
-        RenderChar(text[i], x + (int)i * 8, y);
-    }
+    RenderTextScaled(text, x, y, 1);
 }
 
 void Renderer::RenderTextLarge(const std::string& text, int x, int y, int scale) const {
+    RenderTextScaled(text, x, y, scale);
+}
+
+void Renderer::RenderTextScaled(const std::string& text, int x, int y, int scale) const {
+    textVertices.clear();
+    textIndices.clear();
+    AppendText(text, x, y, scale);
+    FlushText();
+}
+
+void Renderer::AppendText(const std::string& text, int x, int y, int scale) const {
+    if (!fontAtlas) return;
+    
+    SDL_FColor color = {textColor.r / 255.0f, textColor.g / 255.0f, textColor.b / 255.0f, textColor.a / 255.0f};
+    float glyphSize = (float)(GLYPH_SIZE * scale);
+    float texStep = (float)GLYPH_SIZE / ATLAS_SIZE;
+    
     for (size_t i = 0; i < text.length(); ++i) {
-        RenderCharLarge(text[i], x + (int)i * 8 * scale, y, scale);
+        char c = text[i];
+        
+        // Convert character to uppercase if it's lowercase
+        if (c >= 'a' && c <= 'z') {
+            c = c - 'a' + 'A';
+        }
+        
+        uint8_t glyph = (uint8_t)c;
+        if (!glyphHasPixels[glyph]) continue; // Blank glyphs need no quad
+        
+        // One textured quad per character
+        float left = (float)(x + (int)i * GLYPH_SIZE * scale);
+        float top = (float)y;
+        float u = (glyph % ATLAS_GLYPHS_PER_ROW) * texStep;
+        float v = (glyph / ATLAS_GLYPHS_PER_ROW) * texStep;
+        
+        int base = (int)textVertices.size();
+        textVertices.push_back({{left, top}, color, {u, v}});
+        textVertices.push_back({{left + glyphSize, top}, color, {u + texStep, v}});
+        textVertices.push_back({{left + glyphSize, top + glyphSize}, color, {u + texStep, v + texStep}});
+        textVertices.push_back({{left, top + glyphSize}, color, {u, v + texStep}});
+        
+        textIndices.push_back(base);
+        textIndices.push_back(base + 1);
+        textIndices.push_back(base + 2);
+        textIndices.push_back(base);
+        textIndices.push_back(base + 2);
+        textIndices.push_back(base + 3);
+    }
+}
+
+void Renderer::FlushText() const {
+    if (textVertices.empty()) return;
+    
+    // Submit all queued glyphs as a single batch
+    SDL_RenderGeometry(renderer, fontAtlas, textVertices.data(), (int)textVertices.size(),
+                       textIndices.data(), (int)textIndices.size());
+    drawCallCount++;
+    
+    textVertices.clear();
+    textIndices.clear();
+}
+
+void Renderer::BuildFontAtlas() {
+    std::array<std::array<uint8_t, 8>, 256> font;
+    InitializeFontArray(font);
+    
+    // Lit pixels are opaque white so the vertex colour tints the glyph
+    std::vector<Uint32> pixels(ATLAS_SIZE * ATLAS_SIZE, 0x00FFFFFF);
+    
+    for (int glyph = 0; glyph < 256; ++glyph) {
+        int originX = (glyph % ATLAS_GLYPHS_PER_ROW) * GLYPH_SIZE;
+        int originY = (glyph / ATLAS_GLYPHS_PER_ROW) * GLYPH_SIZE;
+        
+        for (int row = 0; row < GLYPH_SIZE; ++row) {
+            uint8_t line = font[glyph][row];
+            for (int col = 0; col < GLYPH_SIZE; ++col) {
+                if (line & (0x80 >> col)) {
+                    pixels[(originY + row) * ATLAS_SIZE + originX + col] = 0xFFFFFFFF;
+                    glyphHasPixels[glyph] = true;
+                }
+            }
+        }
+    }
+    
+    fontAtlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, ATLAS_SIZE, ATLAS_SIZE);
+    if (!fontAtlas) {
+        LOG_ERROR(LogCategory::Render, "Failed to create font atlas: {}", SDL_GetError());
+        return;
     }
+    
+    SDL_UpdateTexture(fontAtlas, nullptr, pixels.data(), ATLAS_SIZE * (int)sizeof(Uint32));
+    SDL_SetTextureBlendMode(fontAtlas, SDL_BLENDMODE_BLEND);
+    // Keep scaled text crisp
+    SDL_SetTextureScaleMode(fontAtlas, SDL_SCALEMODE_NEAREST);
 }
 
 void Renderer::InitializeFontArray(std::array<std::array<uint8_t, 8>, 256>& font) const {
@@ -116,65 +254,43 @@ void Renderer::InitializeFontArray(std::array<std::array<uint8_t, 8>, 256>& font
         font[32] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}; // Space
         // Exclamation mark
         font[33] = {0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00}; // !
-}
-
-void Renderer::RenderChar(char c, int x, int y) const {
-    // Simple bitmap font - 8x8 pixels per character
-    static std::array<std::array<uint8_t, 8>, 256> font;
-    static bool fontInitialized = false;
-    
-    if (!fontInitialized) {
-        InitializeFontArray(font);
-        fontInitialized = true;
-    }
-    
-    // Convert character to uppercase if it's lowercase
-    if (c >= 'a' && c <= 'z') {
-        c = c - 'a' + 'A';
-    }
-    
-    // Draw the character bitmap
-    SDL_SetRenderDrawColor(renderer, textColor.r, textColor.g, textColor.b, textColor.a);
-    
-    for (int row = 0; row < 8; ++row) {
-        uint8_t line = font[(uint8_t)c][row];
-        for (int col = 0; col < 8; ++col) {
-            if (line & (0x80 >> col)) {
-                SDL_FRect pixelRect = {(float)(x + col), (float)(y + row), 1.0f, 1.0f};
-                SDL_RenderFillRect(renderer, &pixelRect);
+        
+        // Punctuation for numbers and debug readouts
+        font[45] = {0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00, 0x00}; // -
+        font[46] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x18, 0x18, 0x00}; // .
+        font[58] = {0x00, 0x18, 0x18, 0x00, 0x18, 0x18, 0x00, 0x00}; // :
+        font[95] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E}; // _
+        font[124] = {0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18}; // |
+        
+        // Histogram bars, filled from the bottom row up
+        for (int level = 1; level <= BAR_GLYPH_LEVELS; ++level) {
+            auto& bar = font[FIRST_BAR_GLYPH + level - 1];
+            for (int row = GLYPH_SIZE - level; row < GLYPH_SIZE; ++row) {
+                bar[row] = 0x7E;
             }
         }
-    }
 }
 
-void Renderer::RenderCharLarge(char c, int x, int y, int scale) const {
-    // Simple bitmap font - 8x8 pixels per character, scaled up
-    static std::array<std::array<uint8_t, 8>, 256> font;
-    static bool fontInitialized = false;
-    
-    if (!fontInitialized) {
-        InitializeFontArray(font);
-        fontInitialized = true;
-    }
-    
-    // Convert character to uppercase if it's lowercase
-    if (c >= 'a' && c <= 'z') {
-        c = c - 'a' + 'A';
-    }
-    
-    // Draw the character bitmap scaled up
-    SDL_SetRenderDrawColor(renderer, textColor.r, textColor.g, textColor.b, textColor.a);
-    
-    for (int row = 0; row < 8; ++row) {
-        uint8_t line = font[(uint8_t)c][row];
-        for (int col = 0; col < 8; ++col) {
-            if (line & (0x80 >> col)) {
-                // Draw a scaled pixel (scale x scale rectangle)
-                SDL_FRect pixelRect = {(float)(x + col * scale), (float)(y + row * scale), (float)scale, (float)scale};
-                SDL_RenderFillRect(renderer, &pixelRect);
-            }
-        }
+void Renderer::BuildGridIndices() {
+    // Two triangles per cell quad; the layout never changes so build it once
+    gridIndices.clear();
+    gridIndices.reserve(10 * 10 * 6);
+    for (int cell = 0; cell < 10 * 10; ++cell) {
+        int base = cell * 4;
+        gridIndices.push_back(base);
+        gridIndices.push_back(base + 1);
+        gridIndices.push_back(base + 2);
+        gridIndices.push_back(base);
+        gridIndices.push_back(base + 2);
+        gridIndices.push_back(base + 3);
     }
+    gridVertices.reserve(10 * 10 * 4);
+    gridLinePoints.reserve(2 * 11 * 2);
+}
+
+void Renderer::BeginFrame() {
+    lastFrameDrawCallCount = drawCallCount;
+    drawCallCount = 0;
 }
 
 SDL_Color Renderer::GetCellColor(CellState state, bool isPlayerGrid) const {
@@ -201,7 +317,7 @@ void Renderer::RenderShipPlacementUI(const ShipManager& shipManager, int instruc
     int currentShipIndex = shipManager.GetCurrentShipIndex();
     
     if (currentShipIndex < ships.size()) {
-        std::string currentShip = "Place: " + ships[currentShipIndex].name + " (" + std::to_string(ships[currentShipIndex].size) + " cells)";
+        std::string currentShip = "Place: " + std::string(ShipManager::GetShipName(currentShipIndex)) + " (" + std::to_string(ships[currentShipIndex].size) + " cells)";
         RenderText(currentShip, GRID_MARGIN, instructionY);
         
         std::string orientation = "Orientation: " + std::string(shipManager.IsHorizontal() ? "Horizontal" : "Vertical");
@@ -209,6 +325,7 @@ void Renderer::RenderShipPlacementUI(const ShipManager& shipManager, int instruc
         
         RenderText("R/Space: Rotate", GRID_MARGIN, instructionY + 30);
         RenderText("1-0: Select ship", GRID_MARGIN, instructionY + 45);
+        RenderText("A: Auto place", GRID_MARGIN, instructionY + 60);
     }
     
     RenderText("Ships to Place:", listX, listY);
@@ -217,7 +334,7 @@ void Renderer::RenderShipPlacementUI(const ShipManager& shipManager, int instruc
         std::string status = ships[i].placed ? "✓" : " ";
         // Format ship number with right alignment (pad single digits with space)
         std::string shipNumber = (i + 1 < 10) ? " " + std::to_string(i + 1) : std::to_string(i + 1);
-        std::string shipInfo = shipNumber + ". " + status + " " + ships[i].name;
+        std::string shipInfo = shipNumber + ". " + status + " " + ShipManager::GetShipName((int)i);
         
         // Highlight current ship
         if (i == currentShipIndex && !ships[i].placed) {
@@ -225,17 +342,27 @@ void Renderer::RenderShipPlacementUI(const ShipManager& shipManager, int instruc
             SDL_FRect highlight = {(float)listX - 2, (float)(listY + 15 + i * 15 - 2), 200.0f, 14.0f};
             SDL_SetRenderDrawColor(renderer, 100, 100, 100, 128);
             SDL_RenderFillRect(renderer, &highlight);
+            drawCallCount++;
         }
         
         RenderText(shipInfo, listX, listY + 15 + i * 15);
     }
 }
 
+void Renderer::RenderPanel(const SDL_FRect& rect, SDL_Color color) const {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    SDL_RenderFillRect(renderer, &rect);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+    drawCallCount++;
+}
+
 void Renderer::RenderGameOverUI(const std::string& victoryMessage, SDL_FRect& playAgainButton, bool playAgainButtonHovered) const {
     // Draw semi-transparent overlay
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
     SDL_FRect overlay = {0, 0, (float)WINDOW_WIDTH, (float)WINDOW_HEIGHT};
     SDL_RenderFillRect(renderer, &overlay);
+    drawCallCount++;
     
     // Calculate text size and position for Game over message
     int textScale = 4; // Make text 4x bigger
@@ -249,9 +376,11 @@ void Renderer::RenderGameOverUI(const std::string& victoryMessage, SDL_FRect& pl
     SDL_FRect messageBg = {(float)messageX - 20, (float)messageY - 15, 
                           (float)messageWidth + 40, (float)messageHeight + 30};
     SDL_RenderFillRect(renderer, &messageBg);
+    drawCallCount++;
     // Draw border for Game over message
     SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
     SDL_RenderRect(renderer, &messageBg);
+    drawCallCount++;
 
     // Render large Game over message
     RenderTextLarge(victoryMessage, messageX, messageY, textScale);
@@ -274,10 +403,12 @@ void Renderer::RenderGameOverUI(const std::string& victoryMessage, SDL_FRect& pl
         SDL_SetRenderDrawColor(renderer, 60, 120, 60, 255); // Dark green
     }
     SDL_RenderFillRect(renderer, &playAgainButton);
+    drawCallCount++;
     
     // Draw button border
     SDL_SetRenderDrawColor(renderer, 200, 200, 200, 255);
     SDL_RenderRect(renderer, &playAgainButton);
+    drawCallCount++;
     
     // Draw button text
     int buttonTextX = buttonX + (buttonWidth - buttonText.length() * 8 * buttonTextScale) / 2;
@@ -293,6 +424,7 @@ void Renderer::RenderGameOverUI(const std::string& victoryMessage, SDL_FRect& pl
     SDL_FRect instructionBg = {(float)instructionX - 10, (float)instructionY - 5, 
                               (float)instructionText.length() * 8 + 20, 18};
     SDL_RenderFillRect(renderer, &instructionBg);
+    drawCallCount++;
     
     RenderText(instructionText, instructionX, instructionY);
 }
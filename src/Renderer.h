@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <array>
+#include <vector>
 #include <SDL3/SDL.h>
 #include "GameState.h"
 
@@ -9,6 +10,10 @@ class ShipManager;
 class Renderer {
 public:
     Renderer(SDL_Renderer* sdlRenderer);
+    ~Renderer();
+    
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
     
     void RenderGrid(int offsetX, int offsetY, const std::array<std::array<CellState, 10>, 10>& grid, 
                    const std::string& title, bool isPlayerGrid = false) const;
@@ -19,14 +24,50 @@ public:
     void RenderShipPlacementUI(const ShipManager& shipManager, int instructionY, int listX, int listY) const;
     void RenderGameOverUI(const std::string& victoryMessage, SDL_FRect& playAgainButton, bool playAgainButtonHovered) const;
     
+    // Alpha-blended rectangle, e.g. behind debug overlays
+    void RenderPanel(const SDL_FRect& rect, SDL_Color color) const;
+    
+    // Glyphs FIRST_BAR_GLYPH.. are bars one to BAR_GLYPH_LEVELS pixels tall,
+    // for histograms drawn as text
+    static constexpr uint8_t FIRST_BAR_GLYPH = 0x80;
+    static constexpr int BAR_GLYPH_LEVELS = 8;
+    
     SDL_Color GetCellColor(CellState state, bool isPlayerGrid) const;
+    
+    // Draw call statistics
+    void BeginFrame();
+    int GetDrawCallCount() const { return drawCallCount; }
+    int GetLastFrameDrawCallCount() const { return lastFrameDrawCallCount; }
 
 private:
     SDL_Renderer* renderer;
     
+    // Glyph atlas: all 256 glyphs of the 8x8 bitmap font baked into one texture
+    static constexpr int GLYPH_SIZE = 8;
+    static constexpr int ATLAS_GLYPHS_PER_ROW = 16;
+    static constexpr int ATLAS_SIZE = GLYPH_SIZE * ATLAS_GLYPHS_PER_ROW;
+    
+    SDL_Texture* fontAtlas;
+    std::array<bool, 256> glyphHasPixels;
+    
+    // Queued glyph quads, reused between text draws to avoid per-string allocations
+    mutable std::vector<SDL_Vertex> textVertices;
+    mutable std::vector<int> textIndices;
+    
+    // Batched grid buffers: one quad per cell, one polyline for all grid lines
+    mutable std::vector<SDL_Vertex> gridVertices;
+    std::vector<int> gridIndices;
+    mutable std::vector<SDL_FPoint> gridLinePoints;
+    
+    mutable int drawCallCount;
+    int lastFrameDrawCallCount;
+    
     void RenderGridLabels(int offsetX, int offsetY) const;
-    void RenderChar(char c, int x, int y) const;
-    void RenderCharLarge(char c, int x, int y, int scale) const;
+    void RenderTextScaled(const std::string& text, int x, int y, int scale) const;
+    void AppendText(const std::string& text, int x, int y, int scale) const;
+    void FlushText() const;
+    void BuildFontAtlas();
+    void BuildGridIndices();
     void InitializeFontArray(std::array<std::array<uint8_t, 8>, 256>& font) const;
     
     // Colors
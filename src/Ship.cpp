@@ -1,141 +1,131 @@
 #include "Ship.h"
 #include "Grid.h"
-#include <vector>
+#include "PlacementTable.h"
+#include "FleetGenerator.h"
+#include <array>
 
-ShipManager::ShipManager() : currentShipIndex(0), isHorizontal(true) {
+namespace {
+
+struct FleetEntry {
+    ShipType type;
+    int size;
+    const char* name;
+};
+
+// The fleet both sides play with, in placement order
+constexpr FleetEntry STANDARD_FLEET[] = {
+    // 1x Battleship (Size 5)
+    {ShipType::Battleship, 5, "Battleship"},
+    
+    // 2x Cruiser (Size 4)
+    {ShipType::Cruiser, 4, "Cruiser 1"},
+    {ShipType::Cruiser, 4, "Cruiser 2"},
+    
+    // 3x Destroyer (Size 3)
+    {ShipType::Destroyer, 3, "Destroyer 1"},
+    {ShipType::Destroyer, 3, "Destroyer 2"},
+    {ShipType::Destroyer, 3, "Destroyer 3"},
+    
+    // 4x Submarine (Size 2)
+    {ShipType::Submarine, 2, "Submarine 1"},
+    {ShipType::Submarine, 2, "Submarine 2"},
+    {ShipType::Submarine, 2, "Submarine 3"},
+    {ShipType::Submarine, 2, "Submarine 4"},
+};
+
+constexpr int STANDARD_FLEET_SIZE = sizeof(STANDARD_FLEET) / sizeof(STANDARD_FLEET[0]);
+static_assert(STANDARD_FLEET_SIZE <= MAX_FLEET_SIZE);
+
+} // namespace
+
+ShipManager::ShipManager() : ships{}, shipCount(0), currentShipIndex(0), isHorizontal(true) {
     InitializeShips();
 }
 
 void ShipManager::Reset() {
     currentShipIndex = 0;
     isHorizontal = true;
-    for (auto& ship : ships) {
+    for (Ship& ship : GetShips()) {
         ship.placed = false;
     }
 }
 
 void ShipManager::InitializeShips() {
-    ships.clear();
-    // 1x Battleship (Size 5)
-    ships.emplace_back(ShipType::Battleship, 5, "Battleship");
-    
-    // 2x Cruiser (Size 4)
-    ships.emplace_back(ShipType::Cruiser, 4, "Cruiser 1");
-    ships.emplace_back(ShipType::Cruiser, 4, "Cruiser 2");
-    
-    // 3x Destroyer (Size 3)
-    ships.emplace_back(ShipType::Destroyer, 3, "Destroyer 1");
-    ships.emplace_back(ShipType::Destroyer, 3, "Destroyer 2");
-    ships.emplace_back(ShipType::Destroyer, 3, "Destroyer 3");
-    
-    // 4x Submarine (Size 2)
-    ships.emplace_back(ShipType::Submarine, 2, "Submarine 1");
-    ships.emplace_back(ShipType::Submarine, 2, "Submarine 2");
-    ships.emplace_back(ShipType::Submarine, 2, "Submarine 3");
-    ships.emplace_back(ShipType::Submarine, 2, "Submarine 4");
+    shipCount = STANDARD_FLEET_SIZE;
+    for (int i = 0; i < shipCount; ++i) {
+        ships[i] = {STANDARD_FLEET[i].type, STANDARD_FLEET[i].size, false};
+    }
+}
+
+const char* ShipManager::GetShipName(int index) {
+    return index >= 0 && index < STANDARD_FLEET_SIZE ? STANDARD_FLEET[index].name : "Ship";
 }
 
-bool ShipManager::IsValidPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) const {
+bool ShipManager::IsValidPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) {
     // Check bounds
-    if (horizontal) {
-        if (startX + shipSize > GRID_SIZE || startY >= GRID_SIZE) {
-            return false;
-        }
-    } else {
-        if (startX >= GRID_SIZE || startY + shipSize > GRID_SIZE) {
-            return false;
-        }
+    if (shipSize < 1 || shipSize > MAX_SHIP_SIZE || !grid.IsValidPosition(startX, startY)) {
+        return false;
     }
     
-    // Check if cells are empty and not adjacent to other ships
-    for (int i = 0; i < shipSize; ++i) {
-        int checkX = horizontal ? startX + i : startX;
-        int checkY = horizontal ? startY : startY + i;
-        
-        // Check if current cell is occupied
-        CellState currentCell = grid.GetCell(checkX, checkY);
-        if (currentCell != CellState::Empty && 
-            currentCell != CellState::Preview && 
-            currentCell != CellState::InvalidPreview) {
-            return false;
-        }
-        
-        // Check adjacent cells (no touching ships rule)
-        for (int dx = -1; dx <= 1; ++dx) {
-            for (int dy = -1; dy <= 1; ++dy) {
-                if (dx == 0 && dy == 0) continue;
-                
-                int adjX = checkX + dx;
-                int adjY = checkY + dy;
-                
-                if (grid.IsValidPosition(adjX, adjY)) {
-                    if (grid.GetCell(adjX, adjY) == CellState::Ship) {
-                        return false;
-                    }
-                }
-            }
-        }
+    const PlacementMasks& masks = GetPlacementMasks(shipSize, horizontal, startX, startY);
+    if (!masks.inBounds) {
+        return false;
     }
     
-    return true;
+    // Ship cells may not have been fired at
+    if ((masks.footprint & (grid.GetHitMask() | grid.GetMissMask())).Any()) {
+        return false;
+    }
+    
+    // Ship and its neighbours may not contain another ship (no touching ships rule)
+    return (masks.halo & grid.GetShipMask()).None();
 }
 
 void ShipManager::PlaceShip(Grid& grid, int startX, int startY, int shipSize, bool horizontal) const {
-    for (int i = 0; i < shipSize; ++i) {
-        int x = horizontal ? startX + i : startX;
-        int y = horizontal ? startY : startY + i;
-        grid.SetCell(x, y, CellState::Ship);
-    }
+    grid.PlaceShip(startX, startY, shipSize, horizontal);
 }
 
 bool ShipManager::IsShipSunk(const Grid& grid, GridPosition hit) const {
-    // Find all connected ship cells and check if they're all hit
-    std::vector<std::vector<bool>> visited(GRID_SIZE, std::vector<bool>(GRID_SIZE, false));
-    std::vector<GridPosition> shipCells;
-    std::vector<GridPosition> toCheck;
-    
-    // Start flood fill from hit position
-    toCheck.push_back(hit);
+    // Each placed ship tracks its own remaining hits
+    int shipId = grid.GetShipId(hit.x, hit.y);
+    return shipId != Grid::NO_SHIP && grid.IsShipSunk(shipId);
+}
+
+bool ShipManager::PlaceRemainingShipsRandomly(Grid& grid, std::mt19937& rng) {
+    std::array<int, MAX_FLEET_SIZE> shipIndices;
+    std::array<int, MAX_FLEET_SIZE> sizes;
+    std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+    int count = 0;
     
-    while (!toCheck.empty()) {
-        GridPosition current = toCheck.back();
-        toCheck.pop_back();
-        
-        if (current.x < 0 || current.x >= GRID_SIZE || current.y < 0 || current.y >= GRID_SIZE || 
-            visited[current.y][current.x]) {
-            continue;
-        }
-        
-        CellState cell = grid.GetCell(current.x, current.y);
-        if (cell == CellState::Ship || cell == CellState::Hit) {
-            visited[current.y][current.x] = true;
-            shipCells.push_back(current);
-            
-            // Add adjacent cells to check
-            toCheck.push_back({current.x - 1, current.y});
-            toCheck.push_back({current.x + 1, current.y});
-            toCheck.push_back({current.x, current.y - 1});
-            toCheck.push_back({current.x, current.y + 1});
+    for (int i = 0; i < shipCount; ++i) {
+        if (!ships[i].placed) {
+            shipIndices[count] = i;
+            sizes[count] = ships[i].size;
+            count++;
         }
     }
     
-    // Check if all ship cells are hit
-    for (auto& cell : shipCells) {
-        if (grid.GetCell(cell.x, cell.y) != CellState::Hit) {
-            return false;
-        }
+    // Cells already fired at can't hold a ship
+    if (!GenerateRandomFleet(std::span<const int>(sizes.data(), count), rng, std::span<ShipPlacement>(placements.data(), count),
+                             grid.GetShipMask(), grid.GetHitMask() | grid.GetMissMask())) {
+        return false;
     }
     
+    for (int i = 0; i < count; ++i) {
+        const ShipPlacement& placement = placements[i];
+        PlaceShip(grid, placement.x, placement.y, placement.size, placement.horizontal);
+        ships[shipIndices[i]].placed = true;
+    }
     return true;
 }
 
 bool ShipManager::AllShipsPlaced() const {
-    return currentShipIndex >= ships.size();
+    return currentShipIndex >= shipCount;
 }
 
 int ShipManager::GetRemainingShipCount(ShipType type) const {
     int count = 0;
-    for (const auto& ship : ships) {
+    for (const Ship& ship : GetShips()) {
         if (ship.type == type && !ship.placed) {
             count++;
         }
@@ -145,7 +135,7 @@ int ShipManager::GetRemainingShipCount(ShipType type) const {
 
 int ShipManager::GetTotalShipCount(ShipType type) const {
     int count = 0;
-    for (const auto& ship : ships) {
+    for (const Ship& ship : GetShips()) {
         if (ship.type == type) {
             count++;
         }
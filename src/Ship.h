@@ -1,25 +1,27 @@
 #pragma once
-#include <vector>
-#include <string>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
 #include "GameState.h"
+#include "BitBoard.h"
+#include "FleetGenerator.h"
 
 class Grid;
 
-enum class ShipType {
+enum class ShipType : uint8_t {
     Battleship = 0,
     Cruiser = 1,
     Destroyer = 2,
     Submarine = 3,
 };
 
+// Plain data so a ShipManager can be copied as is; names come from
+// ShipManager::GetShipName
 struct Ship {
     ShipType type;
     int size;
-    std::string name;
     bool placed;
-    
-    Ship(ShipType t, int s, const std::string& n) 
-        : type(t), size(s), name(n), placed(false) {}
 };
 
 class ShipManager {
@@ -29,14 +31,19 @@ public:
     void Reset();
     void InitializeShips();
     
-    const std::vector<Ship>& GetShips() const { return ships; }
-    std::vector<Ship>& GetShips() { return ships; }
+    std::span<const Ship> GetShips() const { return {ships.data(), (size_t)shipCount}; }
+    std::span<Ship> GetShips() { return {ships.data(), (size_t)shipCount}; }
+    // Display name of ship index, e.g. "Cruiser 2"
+    static const char* GetShipName(int index);
     
-    bool IsValidPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal) const;
+    static bool IsValidPlacement(const Grid& grid, int startX, int startY, int shipSize, bool horizontal);
     void PlaceShip(Grid& grid, int startX, int startY, int shipSize, bool horizontal) const;
     
     bool IsShipSunk(const Grid& grid, GridPosition hit) const;
     
+    // Places every ship not yet placed at a random legal position
+    bool PlaceRemainingShipsRandomly(Grid& grid, std::mt19937& rng);
+    
     bool AllShipsPlaced() const;
     int GetCurrentShipIndex() const { return currentShipIndex; }
     void SetCurrentShipIndex(int index) { currentShipIndex = index; }
@@ -51,7 +58,8 @@ public:
     int GetTotalShipCount(ShipType type) const;
 
 private:
-    std::vector<Ship> ships;
+    std::array<Ship, MAX_FLEET_SIZE> ships;
+    int shipCount;
     int currentShipIndex;
     bool isHorizontal;
 };
@@ -0,0 +1,53 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Bounded single-producer single-consumer queue. Producer and consumer each
+// keep their own index on a separate cache line plus a cached copy of the
+// other's, so neither touches the shared line until it looks full or empty.
+template <typename T, size_t CAPACITY>
+class SpscRing {
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>);
+
+public:
+    // Producer side; false when full
+    bool TryPush(const T& value) {
+        size_t head = producer.head.load(std::memory_order_relaxed);
+        if (head - producer.cachedTail == CAPACITY) {
+            producer.cachedTail = consumer.tail.load(std::memory_order_acquire);
+            if (head - producer.cachedTail == CAPACITY) return false;
+        }
+        slots[head & (CAPACITY - 1)] = value;
+        producer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false when empty
+    bool TryPop(T& value) {
+        size_t tail = consumer.tail.load(std::memory_order_relaxed);
+        if (tail == consumer.cachedHead) {
+            consumer.cachedHead = producer.head.load(std::memory_order_acquire);
+            if (tail == consumer.cachedHead) return false;
+        }
+        value = slots[tail & (CAPACITY - 1)];
+        consumer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    struct alignas(64) ProducerState {
+        std::atomic<size_t> head{0};
+        size_t cachedTail = 0;
+    };
+    struct alignas(64) ConsumerState {
+        std::atomic<size_t> tail{0};
+        size_t cachedHead = 0;
+    };
+
+    ProducerState producer;
+    ConsumerState consumer;
+    alignas(64) std::array<T, CAPACITY> slots;
+};
@@ -1,18 +1,69 @@
 #include "BattleshipGame.h"
+#include "Log.h"
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 
-int main(int argc, char** argv) {
+namespace {
+
+struct Options {
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    int replayGame = 0;
+    int replayShot = 0;
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    bool replayPosition = false;
+    for (int i = 1; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--record") == 0) {
+            options.recordPath = value;
+        } else if (std::strcmp(arg, "--replay") == 0) {
+            options.replayPath = value;
+        } else if (std::strcmp(arg, "--game") == 0) {
+            options.replayGame = std::atoi(value);
+            replayPosition = true;
+        } else if (std::strcmp(arg, "--shot") == 0) {
+            options.replayShot = std::atoi(value);
+            replayPosition = true;
+        } else {
+            return false;
+        }
+    }
+    // --game and --shot pick a position in the replay
+    return !replayPosition || options.replayPath;
+}
+
+} // namespace
+
+// Usage: battleships [--record PATH] [--replay PATH [--game N] [--shot N]]
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "Usage: battleships [--record PATH] [--replay PATH [--game N] [--shot N]]" << std::endl;
+        return 2;
+    }
+    
     BattleshipGame game;
     
     if (!game.Initialize()) {
-        std::cerr << "Failed to initialize game!" << std::endl;
+        LOG_ERROR(LogCategory::General, "Failed to initialize game!");
+        return -1;
+    }
+    if (options.recordPath && !game.StartRecording(options.recordPath)) {
+        return -1;
+    }
+    if (options.replayPath && !game.LoadReplay(options.replayPath, options.replayGame, options.replayShot)) {
         return -1;
     }
     
-    std::cout << "Starting Battleships game..." << std::endl;
+    LOG_INFO(LogCategory::General, "Starting Battleships game...");
     
     game.Run();
     
-    std::cout << "Game ended. Thank you for playing!" << std::endl;
+    LOG_INFO(LogCategory::General, "Game ended. Thank you for playing!");
     return 0;
-}
\ No newline at end of file
+}
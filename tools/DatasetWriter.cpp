@@ -0,0 +1,136 @@
+#include "DatasetWriter.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET = 0xCBF29CE484222325ull;
+constexpr uint64_t FNV_PRIME = 0x100000001B3ull;
+
+uint64_t Fnv1a(uint64_t hash, std::span<const uint8_t> bytes) {
+    for (uint8_t byte : bytes) {
+        hash = (hash ^ byte) * FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace
+
+DatasetWriter::~DatasetWriter() {
+    Close();
+}
+
+bool DatasetWriter::Open(const std::string& directoryPath, uint64_t shardBytes) {
+    Close();
+    directory = directoryPath;
+    uint64_t recordBytes = shardBytes > sizeof(DatasetShardHeader) ? shardBytes - sizeof(DatasetShardHeader) : 0;
+    recordsPerShard = std::max<uint64_t>(1, recordBytes / sizeof(DatasetRecord));
+    shardIndex = 0;
+    recordsWritten = 0;
+    failed = false;
+    closing = false;
+    if (!OpenShard()) {
+        return false;
+    }
+    writer = std::thread(&DatasetWriter::Run, this);
+    return true;
+}
+
+bool DatasetWriter::Close() {
+    if (!writer.joinable()) {
+        return !failed;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closing = true;
+    }
+    wake.notify_one();
+    writer.join();
+    FinishShard();
+    return !failed;
+}
+
+void DatasetWriter::Submit(std::span<const DatasetRecord> records) {
+    bool full;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        front.insert(front.end(), records.begin(), records.end());
+        full = front.size() >= FLUSH_RECORDS;
+    }
+    if (full) {
+        wake.notify_one();
+    }
+}
+
+void DatasetWriter::Run() {
+    while (true) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return closing || front.size() >= FLUSH_RECORDS; });
+            std::swap(front, back);
+            stop = closing;
+        }
+        Write(back);
+        back.clear();
+        if (stop) return;
+    }
+}
+
+void DatasetWriter::Write(std::span<const DatasetRecord> records) {
+    while (!records.empty() && !failed) {
+        if (shardRecords == recordsPerShard) {
+            FinishShard();
+            if (!OpenShard()) return;
+        }
+        size_t count = (size_t)std::min<uint64_t>(records.size(), recordsPerShard - shardRecords);
+        std::span<const DatasetRecord> chunk = records.first(count);
+        if (std::fwrite(chunk.data(), sizeof(DatasetRecord), count, shard) != count) {
+            std::cerr << "Dataset: write failed, stopping" << std::endl;
+            failed = true;
+            return;
+        }
+        shardChecksum =
+            Fnv1a(shardChecksum, {reinterpret_cast<const uint8_t*>(chunk.data()), chunk.size_bytes()});
+        shardRecords += count;
+        recordsWritten += count;
+        records = records.subspan(count);
+    }
+}
+
+bool DatasetWriter::OpenShard() {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/shard-%05d.bsds", shardIndex);
+    std::string path = directory + name;
+    shard = std::fopen(path.c_str(), "wb");
+    if (!shard) {
+        std::cerr << "Dataset: cannot create " << path << std::endl;
+        failed = true;
+        return false;
+    }
+    shardIndex++;
+    shardRecords = 0;
+    shardChecksum = FNV_OFFSET;
+    // Placeholder; the real header goes in once the shard is complete
+    DatasetShardHeader header{};
+    std::fwrite(&header, sizeof(header), 1, shard);
+    return true;
+}
+
+void DatasetWriter::FinishShard() {
+    if (!shard) return;
+    DatasetShardHeader header{};
+    std::memcpy(header.magic, DatasetFormat::MAGIC, sizeof(header.magic));
+    header.version = DatasetFormat::VERSION;
+    header.recordSize = sizeof(DatasetRecord);
+    header.recordCount = shardRecords;
+    header.checksum = shardChecksum;
+    if (std::fseek(shard, 0, SEEK_SET) != 0 || std::fwrite(&header, sizeof(header), 1, shard) != 1) {
+        failed = true;
+    }
+    if (std::fclose(shard) != 0) {
+        failed = true;
+    }
+    shard = nullptr;
+}
@@ -0,0 +1,102 @@
+#pragma once
+#include <bit>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Self-play training data: one fixed-width record per shot, written to shard
+// files DIR/shard-NNNNN.bsds of at most a given size. A shard is a 64-byte
+// header followed by its records, so a loader can memory-map it and view the
+// records as an array (numpy: np.frombuffer with the matching dtype and
+// offset 64). All fields are little-endian.
+namespace DatasetFormat {
+constexpr char MAGIC[4] = {'B', 'S', 'D', 'S'};
+constexpr uint16_t VERSION = 1;
+constexpr uint8_t SHOT_HIT = 0x01;
+constexpr uint8_t SHOT_SUNK = 0x02;
+} // namespace DatasetFormat
+
+struct DatasetShardHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t recordSize;
+    uint64_t recordCount;
+    uint64_t checksum; // FNV-1a 64 of the record bytes
+    uint8_t reserved[40];
+};
+
+// The shooter's view of the target board before the shot, as 128-bit cell
+// masks (cell y * 10 + x is bit cell of lo, then of hi from 64 on), and what
+// came of it
+struct DatasetRecord {
+    uint64_t hits[2];
+    uint64_t misses[2];
+    uint64_t sunk[2]; // Hits on ships that had gone down
+    uint32_t game;
+    uint16_t shot;          // Of this shooter in this game, from 0
+    uint16_t shotsToFinish; // This shooter's shots from this one to the end of the game
+    uint8_t action;         // Cell fired at
+    uint8_t result;         // DatasetFormat::SHOT_* flags
+    uint8_t shooterWon;
+    uint8_t shooter;        // 0 for A, 1 for B
+    uint32_t reserved;
+};
+
+static_assert(sizeof(DatasetShardHeader) == 64 && sizeof(DatasetRecord) == 64);
+static_assert(std::is_trivially_copyable_v<DatasetRecord>);
+static_assert(std::endian::native == std::endian::little, "records are written as they are in memory");
+
+// Simulation threads hand whole games to Submit, which only appends to the
+// front buffer. A writer thread swaps that buffer for the back one and writes
+// it out, so disk stalls never reach the callers: the front buffer grows
+// instead of making them wait.
+class DatasetWriter {
+public:
+    DatasetWriter() = default;
+    ~DatasetWriter();
+
+    DatasetWriter(const DatasetWriter&) = delete;
+    DatasetWriter& operator=(const DatasetWriter&) = delete;
+
+    // The directory must exist; shards hold up to shardBytes each
+    bool Open(const std::string& directoryPath, uint64_t shardBytes);
+    // Writes everything submitted and finishes the last shard
+    bool Close();
+
+    void Submit(std::span<const DatasetRecord> records);
+
+    uint64_t GetRecordCount() const { return recordsWritten; }
+    int GetShardCount() const { return shardIndex; }
+
+private:
+    static constexpr size_t FLUSH_RECORDS = 16 * 1024; // 1 MB
+
+    std::string directory;
+    uint64_t recordsPerShard = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<DatasetRecord> front;
+    bool closing = false;
+    std::thread writer;
+
+    // Writer thread only
+    std::vector<DatasetRecord> back;
+    std::FILE* shard = nullptr;
+    int shardIndex = 0;
+    uint64_t shardRecords = 0;
+    uint64_t shardChecksum = 0;
+    uint64_t recordsWritten = 0;
+    bool failed = false;
+
+    void Run();
+    void Write(std::span<const DatasetRecord> records);
+    bool OpenShard();
+    void FinishShard();
+};
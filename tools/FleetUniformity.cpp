@@ -0,0 +1,168 @@
+#include "FleetGenerator.h"
+#include "PlacementTable.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Chi-square check that UniformFleetSampler draws every legal layout equally often.
+// Usage: battleship_uniformity [--backtracking] [samples-per-layout] [ship sizes...]
+// Every layout of the (small) test fleet is enumerated first, so each sampled
+// layout can be binned. --backtracking runs the same check on GenerateRandomFleet
+// to show the bias the sampler removes.
+
+struct BoardHash {
+    size_t operator()(const BitBoard& board) const {
+        return std::hash<uint64_t>()(board.lo * 0x9E3779B97F4A7C15ull ^ board.hi);
+    }
+};
+
+// Ships can't touch, so the occupied cells identify a layout uniquely
+static BitBoard LayoutCells(const std::vector<ShipPlacement>& placements) {
+    BitBoard cells;
+    for (const ShipPlacement& placement : placements) {
+        cells |= GetPlacementMasks(placement.size, placement.horizontal, placement.x, placement.y).footprint;
+    }
+    return cells;
+}
+
+// Enumerates every layout once. Equal-sized ships take increasing table slots
+// so swapping them doesn't produce the same layout twice.
+static void EnumerateLayouts(const std::vector<int>& sizes, int ship, int minSlot, const BitBoard& blocked,
+                             const BitBoard& cells, std::unordered_map<BitBoard, int, BoardHash>& layouts) {
+    if (ship == (int)sizes.size()) {
+        layouts.emplace(cells, (int)layouts.size());
+        return;
+    }
+
+    int size = sizes[ship];
+    for (int slot = minSlot; slot < 2 * GRID_SIZE * GRID_SIZE; ++slot) {
+        int orientation = slot / (GRID_SIZE * GRID_SIZE);
+        const PlacementMasks& masks = PLACEMENT_TABLE[size][orientation][slot % (GRID_SIZE * GRID_SIZE)];
+        if (!masks.inBounds || (masks.footprint & blocked).Any()) {
+            continue;
+        }
+        bool nextIsSame = ship + 1 < (int)sizes.size() && sizes[ship + 1] == size;
+        EnumerateLayouts(sizes, ship + 1, nextIsSame ? slot + 1 : 0, blocked | masks.halo,
+                         cells | masks.footprint, layouts);
+    }
+}
+
+// Layouts of the game fleet are far too many to enumerate; just report the cost
+static void TimeGameFleet(std::mt19937& rng) {
+    const std::vector<int> gameFleet = {5, 4, 4, 3, 3, 3, 2, 2, 2, 2};
+    std::vector<ShipPlacement> placements(gameFleet.size());
+    UniformFleetSampler sampler;
+    const int samples = 200;
+
+    auto start = std::chrono::steady_clock::now();
+    sampler.Sample(gameFleet, rng, placements);
+    double setupMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; ++i) {
+        sampler.Sample(gameFleet, rng, placements);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Game fleet: first sample " << setupMs << " ms, then " << seconds * 1e3 / samples
+              << " ms/sample, " << sampler.GetAttemptsPerSample() << " attempts/sample" << std::endl;
+}
+
+// Upper tail of the chi-square distribution via the Wilson-Hilferty approximation
+static double ChiSquarePValue(double chiSquare, double degrees) {
+    double variance = 2.0 / (9.0 * degrees);
+    double z = (std::cbrt(chiSquare / degrees) - (1.0 - variance)) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+int main(int argc, char* argv[]) {
+    bool backtracking = false;
+    int samplesPerLayout = 20;
+    std::vector<int> sizes;
+
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--backtracking") == 0) {
+        backtracking = true;
+        arg++;
+    }
+    if (arg < argc) {
+        samplesPerLayout = std::max(5, std::atoi(argv[arg++]));
+    }
+    for (; arg < argc; ++arg) {
+        sizes.push_back(std::atoi(argv[arg]));
+    }
+    if (sizes.empty()) {
+        sizes = {3, 2, 2};
+    }
+    for (int size : sizes) {
+        if (size < 1 || size > MAX_SHIP_SIZE || (int)sizes.size() > MAX_FLEET_SIZE) {
+            std::cerr << "Ship sizes must be 1-" << MAX_SHIP_SIZE << ", at most " << MAX_FLEET_SIZE << " ships" << std::endl;
+            return 2;
+        }
+    }
+    std::sort(sizes.begin(), sizes.end(), std::greater<int>());
+
+    std::unordered_map<BitBoard, int, BoardHash> layouts;
+    EnumerateLayouts(sizes, 0, 0, BitBoard(), BitBoard(), layouts);
+    if (layouts.size() < 2) {
+        std::cerr << "Fleet has " << layouts.size() << " layouts, nothing to test" << std::endl;
+        return 2;
+    }
+
+    long long sampleCount = (long long)layouts.size() * samplesPerLayout;
+    std::cout << "Fleet of " << sizes.size() << " ships: " << layouts.size() << " layouts, "
+              << sampleCount << " samples" << std::endl;
+
+    std::mt19937 rng(12345);
+    UniformFleetSampler sampler;
+    std::vector<ShipPlacement> placements(sizes.size());
+    std::vector<long long> counts(layouts.size(), 0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (long long i = 0; i < sampleCount; ++i) {
+        bool ok = backtracking ? GenerateRandomFleet(sizes, rng, placements) : sampler.Sample(sizes, rng, placements);
+        auto found = ok ? layouts.find(LayoutCells(placements)) : layouts.end();
+        if (found == layouts.end()) {
+            std::cerr << "Sample " << i << " is not a legal layout" << std::endl;
+            return 1;
+        }
+        counts[found->second]++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double expected = (double)samplesPerLayout;
+    double chiSquare = 0.0;
+    long long fewest = counts[0];
+    long long most = counts[0];
+    for (long long count : counts) {
+        double delta = (double)count - expected;
+        chiSquare += delta * delta / expected;
+        fewest = std::min(fewest, count);
+        most = std::max(most, count);
+    }
+    double degrees = (double)layouts.size() - 1.0;
+    double pValue = ChiSquarePValue(chiSquare, degrees);
+
+    std::cout << (backtracking ? "GenerateRandomFleet" : "UniformFleetSampler") << ": "
+              << seconds * 1e6 / (double)sampleCount << " us/sample";
+    if (!backtracking) {
+        std::cout << ", " << sampler.GetAttemptsPerSample() << " attempts/sample";
+    }
+    std::cout << std::endl;
+    std::cout << "Per-layout counts " << fewest << ".." << most << " (expected " << expected << ")" << std::endl;
+    std::cout << "Chi-square " << chiSquare << " with " << degrees << " degrees of freedom, p = " << pValue << std::endl;
+
+    if (!backtracking) {
+        TimeGameFleet(rng);
+    }
+
+    bool uniform = pValue > 0.001;
+    std::cout << (uniform ? "PASS: consistent with uniform" : "FAIL: not uniform") << std::endl;
+    return uniform ? 0 : 1;
+}
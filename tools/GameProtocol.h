@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "FleetGenerator.h"
+#include "GameState.h"
+
+// Wire protocol between battleship_server and its clients. Every message is
+// a two-byte header, type then payload length, followed by the payload.
+// Cells are y * GRID_SIZE + x.
+//
+//   Place    client -> server  ship count, then per ship: anchor cell, size << 1 | horizontal
+//                              Starts a new match against the server's AI
+//   Fire     client -> server  cell
+//   Placed   server -> client  PLACE_OK, or PLACE_REJECTED if the fleet is illegal
+//   Result   server -> client  cell, SHOT_* flags for the client's shot
+//   Incoming server -> client  cell, SHOT_* flags for the server's reply shot
+//   Error    server -> client  ERROR_* code; the message that caused it is ignored
+//
+// The client always fires first, and the server answers every Fire with a
+// Result and, unless the client just won, the Incoming shot. A client may
+// Place again at any time to abandon its match and start a new one.
+namespace GameProtocol {
+
+constexpr uint16_t DEFAULT_PORT = 7777;
+constexpr int HEADER_SIZE = 2;
+constexpr int MAX_PAYLOAD = 1 + 2 * MAX_FLEET_SIZE;
+
+enum class MessageType : uint8_t {
+    Place = 0x01,
+    Fire = 0x02,
+    Placed = 0x81,
+    Result = 0x82,
+    Incoming = 0x83,
+    Error = 0xFF,
+};
+
+constexpr uint8_t PLACE_OK = 0;
+constexpr uint8_t PLACE_REJECTED = 1;
+
+constexpr uint8_t SHOT_HIT = 0x01;
+constexpr uint8_t SHOT_SUNK = 0x02;
+constexpr uint8_t SHOT_GAME_OVER = 0x04;
+
+constexpr uint8_t ERROR_BAD_MESSAGE = 1;
+constexpr uint8_t ERROR_NO_MATCH = 2;
+constexpr uint8_t ERROR_ILLEGAL_SHOT = 3;
+
+inline void AppendMessage(std::vector<uint8_t>& out, MessageType type, std::span<const uint8_t> payload) {
+    out.push_back((uint8_t)type);
+    out.push_back((uint8_t)payload.size());
+    out.insert(out.end(), payload.begin(), payload.end());
+}
+
+inline void AppendPlace(std::vector<uint8_t>& out, std::span<const ShipPlacement> fleet) {
+    uint8_t payload[MAX_PAYLOAD];
+    int length = 0;
+    payload[length++] = (uint8_t)fleet.size();
+    for (const ShipPlacement& ship : fleet) {
+        payload[length++] = (uint8_t)(ship.y * GRID_SIZE + ship.x);
+        payload[length++] = (uint8_t)(ship.size << 1 | (ship.horizontal ? 1 : 0));
+    }
+    AppendMessage(out, MessageType::Place, {payload, (size_t)length});
+}
+
+inline uint8_t ShotFlags(ShotResult result, bool gameOver) {
+    return (result != ShotResult::Miss ? SHOT_HIT : 0) | (result == ShotResult::Sunk ? SHOT_SUNK : 0) |
+           (gameOver ? SHOT_GAME_OVER : 0);
+}
+
+} // namespace GameProtocol
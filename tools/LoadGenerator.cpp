@@ -0,0 +1,331 @@
+#include "FleetGenerator.h"
+#include "GameProtocol.h"
+#include "Net.h"
+#include "Ship.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sys/epoll.h>
+#include <thread>
+#include <vector>
+
+// Load generator for battleship_server.
+// Usage: battleship_loadgen [--host IP] [--port N] [--sessions N] [--threads N] [--seconds N] [--seed N]
+// Opens the given number of sessions, spread over the threads, each with its
+// own epoll loop. Every session places a random fleet, fires at the cells in
+// a random order until its match ends, then starts another. The time from
+// sending a Fire to receiving its Result is recorded for every shot, and the
+// throughput and latency percentiles are printed at the end.
+
+namespace {
+
+using namespace GameProtocol;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    uint32_t host = INADDR_LOOPBACK;
+    uint16_t port = DEFAULT_PORT;
+    int sessions = 1000;
+    int threads = 1;
+    int seconds = 10;
+    uint64_t seed = 1;
+};
+
+struct ClientSession {
+    int fd = -1;
+    bool connected = false;
+    std::array<uint8_t, GRID_SIZE * GRID_SIZE> cells; // Firing order
+    int nextCell = 0;
+    Clock::time_point fireTime;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+    bool waitingForWritable = false;
+};
+
+struct LoopResults {
+    std::vector<uint32_t> latencies; // Nanoseconds, one per Result
+    uint64_t matches = 0;
+    uint64_t errors = 0;
+    uint64_t failedSessions = 0;
+};
+
+class ClientLoop {
+public:
+    ClientLoop(const Options& options, int sessionCount, uint64_t seed)
+        : options(options), rng((uint32_t)seed), sessions(sessionCount) {
+        ShipManager shipManager;
+        for (const Ship& ship : shipManager.GetShips()) {
+            fleet.push_back(ship.size);
+        }
+        results.latencies.reserve(1 << 20);
+    }
+
+    ~ClientLoop() {
+        for (ClientSession& session : sessions) {
+            if (session.fd >= 0) close(session.fd);
+        }
+        if (epoll >= 0) close(epoll);
+    }
+
+    void Run(Clock::time_point deadline) {
+        epoll = epoll_create1(0);
+        sockaddr_in address = MakeAddress(options.host, options.port);
+        for (ClientSession& session : sessions) {
+            session.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+            if (session.fd < 0) {
+                results.failedSessions++;
+                continue;
+            }
+            SetNoDelay(session.fd);
+            if (connect(session.fd, (sockaddr*)&address, sizeof(address)) != 0 && errno != EINPROGRESS) {
+                Fail(session);
+                continue;
+            }
+            // Writable once the connection is up
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT;
+            event.data.ptr = &session;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, session.fd, &event);
+            session.waitingForWritable = true;
+        }
+
+        epoll_event events[256];
+        while (Clock::now() < deadline) {
+            int count = epoll_wait(epoll, events, 256, 100);
+            for (int i = 0; i < count; ++i) {
+                ClientSession& session = *(ClientSession*)events[i].data.ptr;
+                if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    Fail(session);
+                    continue;
+                }
+                if (events[i].events & EPOLLOUT) {
+                    if (!session.connected) {
+                        session.connected = true;
+                        StartMatch(session);
+                    }
+                    if (!Flush(session)) {
+                        Fail(session);
+                        continue;
+                    }
+                }
+                if (events[i].events & EPOLLIN) {
+                    Receive(session);
+                }
+            }
+        }
+    }
+
+    LoopResults& GetResults() { return results; }
+
+private:
+    const Options& options;
+    std::mt19937 rng;
+    std::vector<int> fleet;
+    std::vector<ClientSession> sessions;
+    int epoll = -1;
+    LoopResults results;
+
+    void Fail(ClientSession& session) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, session.fd, nullptr);
+        close(session.fd);
+        session.fd = -1;
+        results.failedSessions++;
+    }
+
+    void StartMatch(ClientSession& session) {
+        std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+        std::span<ShipPlacement> layout(placements.data(), fleet.size());
+        GenerateRandomFleet(fleet, rng, layout);
+        AppendPlace(session.output, layout);
+        std::iota(session.cells.begin(), session.cells.end(), 0);
+        std::shuffle(session.cells.begin(), session.cells.end(), rng);
+        session.nextCell = 0;
+    }
+
+    void FireNext(ClientSession& session) {
+        uint8_t cell = session.cells[session.nextCell++];
+        AppendMessage(session.output, MessageType::Fire, {&cell, 1});
+        session.fireTime = Clock::now();
+    }
+
+    void Receive(ClientSession& session) {
+        uint8_t buffer[4096];
+        while (true) {
+            ssize_t received = recv(session.fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                session.input.insert(session.input.end(), buffer, buffer + received);
+                if (received < (ssize_t)sizeof(buffer)) break;
+            } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                Fail(session);
+                return;
+            }
+        }
+
+        size_t offset = 0;
+        while (session.input.size() - offset >= HEADER_SIZE) {
+            const uint8_t* message = session.input.data() + offset;
+            size_t length = message[1];
+            if (session.input.size() - offset < HEADER_SIZE + length) break;
+            Handle(session, (MessageType)message[0], {message + HEADER_SIZE, length});
+            offset += HEADER_SIZE + length;
+        }
+        session.input.erase(session.input.begin(), session.input.begin() + offset);
+        if (!Flush(session)) Fail(session);
+    }
+
+    void Handle(ClientSession& session, MessageType type, std::span<const uint8_t> payload) {
+        switch (type) {
+        case MessageType::Placed:
+            if (payload.size() == 1 && payload[0] == PLACE_OK) {
+                FireNext(session);
+            } else {
+                results.errors++;
+                StartMatch(session);
+            }
+            break;
+        case MessageType::Result:
+            results.latencies.push_back(
+                (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - session.fireTime)
+                    .count());
+            if (payload.size() == 2 && (payload[1] & SHOT_GAME_OVER)) {
+                results.matches++;
+                StartMatch(session);
+            }
+            break;
+        case MessageType::Incoming:
+            if (payload.size() == 2 && (payload[1] & SHOT_GAME_OVER)) {
+                results.matches++;
+                StartMatch(session);
+            } else {
+                FireNext(session);
+            }
+            break;
+        default:
+            // Out of step with the server; start over
+            results.errors++;
+            StartMatch(session);
+            break;
+        }
+    }
+
+    bool Flush(ClientSession& session) {
+        size_t sent = 0;
+        while (sent < session.output.size()) {
+            ssize_t written = send(session.fd, session.output.data() + sent, session.output.size() - sent, MSG_NOSIGNAL);
+            if (written > 0) {
+                sent += written;
+            } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                return false;
+            }
+        }
+        session.output.erase(session.output.begin(), session.output.begin() + sent);
+
+        bool pending = !session.output.empty();
+        if (pending != session.waitingForWritable) {
+            epoll_event event{};
+            event.events = EPOLLIN | (pending ? (uint32_t)EPOLLOUT : 0u);
+            event.data.ptr = &session;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, session.fd, &event);
+            session.waitingForWritable = pending;
+        }
+        return true;
+    }
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--host") == 0) {
+            in_addr address;
+            if (inet_pton(AF_INET, value, &address) != 1) return false;
+            options.host = ntohl(address.s_addr);
+        } else if (std::strcmp(arg, "--port") == 0) {
+            options.port = (uint16_t)std::atoi(value);
+        } else if (std::strcmp(arg, "--sessions") == 0) {
+            options.sessions = std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--seconds") == 0) {
+            options.seconds = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else {
+            return false;
+        }
+    }
+    return options.sessions > 0 && options.threads > 0 && options.seconds > 0;
+}
+
+double Percentile(std::vector<uint32_t>& values, double fraction) {
+    size_t rank = std::min(values.size() - 1, (size_t)(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank] / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "Usage: battleship_loadgen [--host IP] [--port N] [--sessions N] [--threads N] [--seconds N] "
+                     "[--seed N]"
+                  << std::endl;
+        return 2;
+    }
+    RaiseDescriptorLimit();
+    int threadCount = std::min(options.threads, options.sessions);
+
+    std::vector<std::unique_ptr<ClientLoop>> loops;
+    for (int i = 0; i < threadCount; ++i) {
+        int sessionCount = options.sessions / threadCount + (i < options.sessions % threadCount ? 1 : 0);
+        loops.push_back(std::make_unique<ClientLoop>(options, sessionCount, options.seed + i));
+    }
+
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::seconds(options.seconds);
+    std::vector<std::thread> threads;
+    for (auto& loop : loops) {
+        threads.emplace_back(&ClientLoop::Run, loop.get(), deadline);
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    LoopResults total;
+    for (auto& loop : loops) {
+        LoopResults& results = loop->GetResults();
+        total.latencies.insert(total.latencies.end(), results.latencies.begin(), results.latencies.end());
+        total.matches += results.matches;
+        total.errors += results.errors;
+        total.failedSessions += results.failedSessions;
+    }
+
+    std::cout << options.sessions - total.failedSessions << " of " << options.sessions << " sessions, "
+              << total.matches << " matches, " << total.errors << " errors" << std::endl;
+    if (total.latencies.empty()) {
+        std::cout << "No shots answered" << std::endl;
+        return 1;
+    }
+    uint32_t slowest = *std::max_element(total.latencies.begin(), total.latencies.end());
+    std::cout << std::fixed << std::setprecision(0) << total.latencies.size() / elapsed << " fires/s" << std::endl;
+    std::cout << std::setprecision(1) << "Fire to result: p50 " << Percentile(total.latencies, 0.50) << " us, p99 "
+              << Percentile(total.latencies, 0.99) << " us, p99.9 " << Percentile(total.latencies, 0.999)
+              << " us, max " << slowest / 1000.0 << " us" << std::endl;
+    return total.failedSessions == 0 ? 0 : 1;
+}
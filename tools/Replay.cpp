@@ -0,0 +1,217 @@
+#include "GameIndex.h"
+#include "GameRecord.h"
+#include "MappedFile.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// Replays a game-record file through the game rules as fast as possible.
+// Usage: battleship_replay [--limit N] [--quiet] FILE
+//        battleship_replay --index FILE
+//        battleship_replay --seek GAME SHOT FILE
+// The file is memory-mapped and its games decoded in place. Every recorded
+// shot is fired again and its result, sunk flag and shooter checked against
+// the record, as is the winner of every finished game, so the tool doubles as
+// a consistency check for recordings made with an older build.
+//
+// --index writes the game index FILE.idx. --seek prints both boards as
+// they stood after SHOT shots of game GAME (both counted from 0), using the
+// index, which is built first if it is missing or out of date.
+
+namespace {
+
+struct ReplayTotals {
+    uint64_t games = 0;
+    uint64_t shots = 0;
+    uint64_t mismatchedGames = 0;
+    uint64_t abandonedGames = 0;
+};
+
+std::string DescribeShot(int index, const RecordedShot& shot) {
+    return "shot " + std::to_string(index) + " (" + std::to_string(shot.x) + "," + std::to_string(shot.y) + ")";
+}
+
+// Empty on success, otherwise what first disagreed with the record
+std::string ReplayGame(const GameRecordView& game, Match& match) {
+    if (!SetUpRecordedMatch(game, match)) {
+        return "fleet cannot be placed";
+    }
+    for (int i = 0; i < game.GetShotCount(); ++i) {
+        RecordedShot shot = game.GetShot(i);
+        if (shot.shooter != match.GetSideToMove()) {
+            return DescribeShot(i, shot) + ": wrong side to move";
+        }
+        ShotOutcome outcome;
+        if (!match.Fire(shot.x, shot.y, outcome)) {
+            return DescribeShot(i, shot) + ": illegal";
+        }
+        if ((outcome.result != ShotResult::Miss) != shot.hit || (outcome.result == ShotResult::Sunk) != shot.sunk) {
+            return DescribeShot(i, shot) + ": result differs";
+        }
+    }
+    if (!game.abandoned && (!match.IsOver() || match.GetWinner() != game.winner)) {
+        return "winner differs";
+    }
+    return {};
+}
+
+int BuildIndex(const char* path, std::span<const uint8_t> records) {
+    auto start = std::chrono::steady_clock::now();
+    std::string error;
+    if (!BuildGameIndex(records, GetGameIndexPath(path), error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    GameIndex index;
+    if (!index.Open(GetGameIndexPath(path), records.size(), error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    std::cout << "Indexed " << index.GetGameCount() << " games, " << index.GetEntryCount() << " entries in "
+              << seconds << " s" << std::endl;
+    return 0;
+}
+
+void PrintBoards(const Match& match) {
+    std::cout << "   Player       AI" << std::endl;
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        std::cout << (y + 1 < 10 ? " " : "") << y + 1 << " ";
+        for (Side side : {Side::Player, Side::AI}) {
+            for (int x = 0; x < GRID_SIZE; ++x) {
+                switch (match.GetGrid(side).GetCell(x, y)) {
+                    case CellState::Ship: std::cout << 'O'; break;
+                    case CellState::Hit: std::cout << 'X'; break;
+                    case CellState::Miss: std::cout << '.'; break;
+                    default: std::cout << ' '; break;
+                }
+            }
+            std::cout << "   ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+int Seek(const char* path, std::span<const uint8_t> records, uint32_t gameNumber, int shot) {
+    GameIndex index;
+    std::string error;
+    if (!index.Open(GetGameIndexPath(path), records.size(), error)) {
+        std::cout << "Building the index (" << error << ")" << std::endl;
+        if (!BuildGameIndex(records, GetGameIndexPath(path), error) ||
+            !index.Open(GetGameIndexPath(path), records.size(), error)) {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    Match match;
+    GameRecordView game;
+    auto start = std::chrono::steady_clock::now();
+    if (!SeekRecordedGame(index, records, gameNumber, shot, match, game)) {
+        std::cerr << "No shot " << shot << " in game " << gameNumber << " (" << index.GetGameCount() << " games)"
+                  << std::endl;
+        return 1;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Game " << gameNumber << " (seed " << game.seed << ", offset " << game.offset << ") after " << shot
+              << " of " << game.GetShotCount() << " shots, found in " << seconds * 1e6 << " us" << std::endl;
+    PrintBoards(match);
+    if (match.IsOver()) {
+        std::cout << (match.GetWinner() == Side::Player ? "Player" : "AI") << " has won" << std::endl;
+    } else if (shot < game.GetShotCount()) {
+        RecordedShot next = game.GetShot(shot);
+        std::cout << "Next: " << (next.shooter == Side::Player ? "Player" : "AI") << " fires at "
+                  << (char)('A' + next.x) << next.y + 1 << (next.sunk ? ", sinks" : next.hit ? ", hits" : ", misses")
+                  << std::endl;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    uint64_t limit = UINT64_MAX;
+    bool quiet = false;
+    bool buildIndex = false;
+    bool seek = false;
+    uint32_t seekGame = 0;
+    int seekShot = 0;
+    const char* path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--quiet") == 0) {
+            quiet = true;
+        } else if (std::strcmp(argv[i], "--index") == 0) {
+            buildIndex = true;
+        } else if (std::strcmp(argv[i], "--seek") == 0 && i + 2 < argc) {
+            seek = true;
+            seekGame = (uint32_t)std::strtoul(argv[++i], nullptr, 10);
+            seekShot = std::atoi(argv[++i]);
+        } else {
+            path = argv[i];
+        }
+    }
+    if (!path) {
+        std::cerr << "Usage: battleship_replay [--limit N] [--quiet] FILE\n"
+                     "       battleship_replay --index FILE\n"
+                     "       battleship_replay --seek GAME SHOT FILE"
+                  << std::endl;
+        return 2;
+    }
+
+    MappedFile file;
+    std::string error;
+    if (!file.Open(path, error)) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+    GameRecordReader reader(file.GetBytes());
+    if (!reader.HasValidHeader()) {
+        std::cerr << path << " is not a game-record file" << std::endl;
+        return 1;
+    }
+    if (buildIndex) {
+        return BuildIndex(path, file.GetBytes());
+    }
+    if (seek) {
+        return Seek(path, file.GetBytes(), seekGame, seekShot);
+    }
+
+    ReplayTotals totals;
+    Match match;
+    GameRecordView game;
+    auto start = std::chrono::steady_clock::now();
+    while (totals.games < limit && reader.Next(game)) {
+        totals.games++;
+        totals.shots += game.GetShotCount();
+        if (game.abandoned) {
+            totals.abandonedGames++;
+        }
+        std::string mismatch = ReplayGame(game, match);
+        if (!mismatch.empty()) {
+            totals.mismatchedGames++;
+            if (!quiet) {
+                std::cerr << "Game at offset " << game.offset << " (seed " << game.seed << "): " << mismatch
+                          << std::endl;
+            }
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (reader.HasError()) {
+        std::cerr << "Corrupt or truncated game at offset " << reader.GetOffset() << std::endl;
+    }
+
+    double megabytes = (double)reader.GetOffset() / (1024.0 * 1024.0);
+    std::cout << "Replayed " << totals.games << " games (" << totals.abandonedGames << " abandoned), "
+              << totals.shots << " shots in " << seconds << " s" << std::endl;
+    if (seconds > 0.0) {
+        std::cout << "Games/sec: " << totals.games / seconds << ", shots/sec: " << totals.shots / seconds
+                  << ", MB/sec: " << megabytes / seconds << std::endl;
+    }
+    std::cout << "Mismatched games: " << totals.mismatchedGames << std::endl;
+    return totals.mismatchedGames == 0 && !reader.HasError() ? 0 : 1;
+}
@@ -0,0 +1,374 @@
+#include "AIPlayer.h"
+#include "GameProtocol.h"
+#include "Match.h"
+#include "Net.h"
+#include "Ship.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sys/epoll.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Headless match server for bots.
+// Usage: battleship_server [--host IP] [--port N] [--threads N] [--ai random|density|hard] [--seed N]
+// Every connection is a session playing matches against the server's AI over
+// the protocol in GameProtocol.h. Each thread runs its own epoll loop with its
+// own SO_REUSEPORT listening socket, so the kernel spreads connections over the
+// loops and a session lives on one loop for good: nothing on the hot path is
+// shared between threads. Binds to 127.0.0.1 unless told otherwise. Stops on
+// SIGINT or SIGTERM.
+
+namespace {
+
+using namespace GameProtocol;
+
+struct Options {
+    uint32_t host = INADDR_LOOPBACK;
+    uint16_t port = DEFAULT_PORT;
+    int threads = 0;
+    TargetingStrategy strategy = TargetingStrategy::ProbabilityDensity;
+    uint64_t seed = 1;
+};
+
+std::atomic<bool> stopRequested{false};
+
+void OnSignal(int) {
+    stopRequested.store(true);
+}
+
+struct Session {
+    int fd;
+    Match match;
+    AIPlayer ai;
+    bool inMatch = false;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+    bool waitingForWritable = false;
+
+    Session(int fd, uint64_t seed) : fd(fd), ai(seed) {}
+};
+
+struct alignas(64) LoopStats {
+    uint64_t sessions = 0;
+    uint64_t matches = 0;
+    uint64_t shots = 0;
+};
+
+class EventLoop {
+public:
+    EventLoop(const Options& options, int index) : options(options), rng((uint32_t)(options.seed + index)) {
+        ShipManager shipManager;
+        for (const Ship& ship : shipManager.GetShips()) {
+            fleet.push_back(ship.size);
+        }
+        std::sort(fleet.begin(), fleet.end());
+    }
+
+    ~EventLoop() {
+        for (auto& [fd, session] : sessions) {
+            close(fd);
+        }
+        if (listener >= 0) close(listener);
+        if (epoll >= 0) close(epoll);
+    }
+
+    bool Listen() {
+        listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        int enabled = 1;
+        setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+        setsockopt(listener, SOL_SOCKET, SO_REUSEPORT, &enabled, sizeof(enabled));
+        sockaddr_in address = MakeAddress(options.host, options.port);
+        if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+            std::cerr << "Cannot listen on port " << options.port << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        epoll = epoll_create1(0);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr; // The listener
+        return epoll >= 0 && epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &event) == 0;
+    }
+
+    void Run() {
+        epoll_event events[256];
+        while (!stopRequested.load(std::memory_order_relaxed)) {
+            int count = epoll_wait(epoll, events, 256, 200);
+            for (int i = 0; i < count; ++i) {
+                auto* session = (Session*)events[i].data.ptr;
+                if (!session) {
+                    AcceptAll();
+                } else if (events[i].events & (EPOLLERR | EPOLLHUP)) {
+                    CloseSession(*session);
+                } else {
+                    if ((events[i].events & EPOLLOUT) && !Flush(*session)) {
+                        CloseSession(*session);
+                    } else if ((events[i].events & EPOLLIN) && !Receive(*session)) {
+                        CloseSession(*session);
+                    }
+                }
+            }
+        }
+    }
+
+    const LoopStats& GetStats() const { return stats; }
+
+private:
+    const Options& options;
+    std::mt19937 rng;
+    std::vector<int> fleet; // Sorted sizes, to check the client's fleet against
+    int listener = -1;
+    int epoll = -1;
+    std::unordered_map<int, std::unique_ptr<Session>> sessions;
+    LoopStats stats;
+
+    void AcceptAll() {
+        while (true) {
+            int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0) return; // EAGAIN, or out of descriptors until someone leaves
+            SetNoDelay(fd);
+            auto session = std::make_unique<Session>(fd, ((uint64_t)rng() << 32) | rng());
+            session->ai.SetVerbose(false);
+            session->ai.SetTargetingStrategy(options.strategy);
+            session->ai.SetMonteCarloThreadCount(1); // Every core already runs a loop
+            session->ai.SetEndgameEnabled(false);    // Its 1 MB table per session would cap the session count
+            epoll_event event{};
+            event.events = EPOLLIN;
+            event.data.ptr = session.get();
+            epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+            sessions.emplace(fd, std::move(session));
+            stats.sessions++;
+        }
+    }
+
+    void CloseSession(Session& session) {
+        int fd = session.fd;
+        epoll_ctl(epoll, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        sessions.erase(fd); // Destroys the session
+    }
+
+    // False once the session should be closed
+    bool Receive(Session& session) {
+        uint8_t buffer[4096];
+        while (true) {
+            ssize_t received = recv(session.fd, buffer, sizeof(buffer), 0);
+            if (received > 0) {
+                session.input.insert(session.input.end(), buffer, buffer + received);
+                if (received < (ssize_t)sizeof(buffer)) break;
+            } else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                return false;
+            }
+        }
+
+        size_t offset = 0;
+        while (session.input.size() - offset >= HEADER_SIZE) {
+            const uint8_t* message = session.input.data() + offset;
+            size_t length = message[1];
+            if (session.input.size() - offset < HEADER_SIZE + length) break;
+            if (!Handle(session, (MessageType)message[0], {message + HEADER_SIZE, length})) return false;
+            offset += HEADER_SIZE + length;
+        }
+        session.input.erase(session.input.begin(), session.input.begin() + offset);
+        return Flush(session);
+    }
+
+    bool Handle(Session& session, MessageType type, std::span<const uint8_t> payload) {
+        if (type == MessageType::Place) {
+            HandlePlace(session, payload);
+            return true;
+        }
+        if (type == MessageType::Fire && payload.size() == 1) {
+            return HandleFire(session, payload[0]);
+        }
+        SendError(session, ERROR_BAD_MESSAGE);
+        return true;
+    }
+
+    void HandlePlace(Session& session, std::span<const uint8_t> payload) {
+        session.match.Reset();
+        session.ai.Reset();
+        session.inMatch = false;
+
+        size_t shipCount = payload.empty() ? 0 : payload[0];
+        if (payload.size() != 1 + 2 * shipCount || shipCount != fleet.size()) {
+            SendPlaced(session, PLACE_REJECTED);
+            return;
+        }
+        std::vector<int> sizes;
+        for (size_t i = 0; i < shipCount; ++i) {
+            uint8_t anchor = payload[1 + 2 * i];
+            uint8_t shape = payload[2 + 2 * i];
+            sizes.push_back(shape >> 1);
+            if (anchor >= GRID_SIZE * GRID_SIZE ||
+                !session.match.PlaceShip(Side::Player, anchor % GRID_SIZE, anchor / GRID_SIZE, shape >> 1, shape & 1)) {
+                SendPlaced(session, PLACE_REJECTED);
+                return;
+            }
+        }
+        std::sort(sizes.begin(), sizes.end());
+        // The backtracking generator: uniform sampling costs ~10 ms, far too
+        // long to keep every other session on this loop waiting
+        if (sizes != fleet || !session.match.PlaceFleetRandomly(Side::AI, fleet, rng)) {
+            session.match.Reset();
+            SendPlaced(session, PLACE_REJECTED);
+            return;
+        }
+        session.match.StartBattle(Side::Player);
+        session.inMatch = true;
+        stats.matches++;
+        SendPlaced(session, PLACE_OK);
+    }
+
+    // False if the session broke while sending
+    bool HandleFire(Session& session, uint8_t cell) {
+        Match& match = session.match;
+        if (!session.inMatch || match.IsOver()) {
+            SendError(session, ERROR_NO_MATCH);
+            return true;
+        }
+        ShotOutcome outcome;
+        if (cell >= GRID_SIZE * GRID_SIZE || !match.Fire(cell % GRID_SIZE, cell / GRID_SIZE, outcome)) {
+            SendError(session, ERROR_ILLEGAL_SHOT);
+            return true;
+        }
+        stats.shots++;
+        uint8_t result[2] = {cell, ShotFlags(outcome.result, outcome.matchOver)};
+        AppendMessage(session.output, MessageType::Result, result);
+        if (outcome.matchOver) return true;
+
+        // The result goes out before the AI starts thinking
+        if (!Flush(session)) return false;
+        const Grid& target = match.GetGrid(Side::Player);
+        GridPosition shot = session.ai.GetTarget(target);
+        if (!match.Fire(shot.x, shot.y, outcome)) {
+            SendError(session, ERROR_ILLEGAL_SHOT); // Never expected: the AI only picks open cells
+            return true;
+        }
+        if (outcome.result != ShotResult::Miss) {
+            session.ai.SetLastHit(shot);
+        }
+        if (outcome.result == ShotResult::Sunk) {
+            session.ai.NotifyShipSunk(target.GetShipCells(outcome.shipId));
+        }
+        uint8_t incoming[2] = {(uint8_t)BitBoard::CellIndex(shot.x, shot.y),
+                               ShotFlags(outcome.result, outcome.matchOver)};
+        AppendMessage(session.output, MessageType::Incoming, incoming);
+        return true;
+    }
+
+    void SendPlaced(Session& session, uint8_t status) {
+        AppendMessage(session.output, MessageType::Placed, {&status, 1});
+    }
+
+    void SendError(Session& session, uint8_t code) {
+        AppendMessage(session.output, MessageType::Error, {&code, 1});
+    }
+
+    // Sends what it can; the rest waits for EPOLLOUT. False if the connection failed.
+    bool Flush(Session& session) {
+        size_t sent = 0;
+        while (sent < session.output.size()) {
+            ssize_t written = send(session.fd, session.output.data() + sent, session.output.size() - sent, MSG_NOSIGNAL);
+            if (written > 0) {
+                sent += written;
+            } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                return false;
+            }
+        }
+        session.output.erase(session.output.begin(), session.output.begin() + sent);
+
+        bool pending = !session.output.empty();
+        if (pending != session.waitingForWritable) {
+            epoll_event event{};
+            event.events = EPOLLIN | (pending ? (uint32_t)EPOLLOUT : 0u);
+            event.data.ptr = &session;
+            epoll_ctl(epoll, EPOLL_CTL_MOD, session.fd, &event);
+            session.waitingForWritable = pending;
+        }
+        return true;
+    }
+};
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i += 2) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (!value) return false;
+        if (std::strcmp(arg, "--host") == 0) {
+            in_addr address;
+            if (inet_pton(AF_INET, value, &address) != 1) return false;
+            options.host = ntohl(address.s_addr);
+        } else if (std::strcmp(arg, "--port") == 0) {
+            options.port = (uint16_t)std::atoi(value);
+        } else if (std::strcmp(arg, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options.seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--ai") == 0) {
+            if (std::strcmp(value, "random") == 0) options.strategy = TargetingStrategy::RandomAdjacent;
+            else if (std::strcmp(value, "density") == 0) options.strategy = TargetingStrategy::ProbabilityDensity;
+            else if (std::strcmp(value, "hard") == 0) options.strategy = TargetingStrategy::MonteCarlo;
+            else return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "Usage: battleship_server [--host IP] [--port N] [--threads N] [--ai random|density|hard] "
+                     "[--seed N]"
+                  << std::endl;
+        return 2;
+    }
+    int threadCount = options.threads > 0 ? options.threads : std::max(1, (int)std::thread::hardware_concurrency());
+    RaiseDescriptorLimit();
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+
+    std::vector<std::unique_ptr<EventLoop>> loops;
+    for (int i = 0; i < threadCount; ++i) {
+        loops.push_back(std::make_unique<EventLoop>(options, i));
+        if (!loops.back()->Listen()) {
+            return 1;
+        }
+    }
+    std::cout << "Serving " << GetTargetingStrategyName(options.strategy) << " AI on port " << options.port
+              << " with " << threadCount << " loops" << std::endl;
+
+    std::vector<std::thread> threads;
+    for (auto& loop : loops) {
+        threads.emplace_back(&EventLoop::Run, loop.get());
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    LoopStats total;
+    for (const auto& loop : loops) {
+        total.sessions += loop->GetStats().sessions;
+        total.matches += loop->GetStats().matches;
+        total.shots += loop->GetStats().shots;
+    }
+    std::cout << "Served " << total.sessions << " sessions, " << total.matches << " matches, " << total.shots
+              << " client shots" << std::endl;
+    return 0;
+}
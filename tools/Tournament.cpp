@@ -0,0 +1,684 @@
+#include "AIPlayer.h"
+#include "DatasetWriter.h"
+#include "FleetGenerator.h"
+#include "GameRecord.h"
+#include "Match.h"
+#include "SpscRing.h"
+#include "WorkStealing.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Headless AI-vs-AI tournament.
+// Usage: battleship_tournament [--games N] [--threads N] [--seed N] [--a STRATEGY] [--b STRATEGY]
+//                              [--budget-us N] [--fast-placement] [--record PATH]
+//                              [--dataset DIR [--shard-mb N]]
+//                              [--sprt [--delta SHOTS] [--alpha P] [--beta P]]
+// STRATEGY is random, density or hard. Game i is fully determined by the base
+// seed and i (hard aside, whose sampling depends on its time budget). Sides
+// alternate the first shot. Fleets are drawn uniformly unless --fast-placement
+// asks for the (biased) backtracking generator; an exact draw costs far more
+// than a game, so long runs reuse a pool of them (see LayoutPool). --record writes every game to
+// PATH in the binary game-record format (see battleship_replay); A plays the
+// player side. --dataset writes one training record per shot (the shooter's
+// view of the board, the cell it chose and how the game ended for it) to
+// shard files of at most N MB (default 64) in DIR; see DatasetWriter.h.
+//
+// --sprt compares A and B instead of playing them against each other: for
+// every game both shoot alone at the same hidden fleet with the same seed, and
+// a sequential probability ratio test on shotsB - shotsA stops the run once it
+// can tell "A is better by DELTA shots" (H1) from "no difference" (H0) at the
+// given error rates. --games then caps the run.
+
+namespace {
+
+struct Options {
+    uint32_t games = 10000;
+    int threads = 0;
+    uint64_t seed = 1;
+    TargetingStrategy strategyA = TargetingStrategy::ProbabilityDensity;
+    TargetingStrategy strategyB = TargetingStrategy::RandomAdjacent;
+    int budgetUs = 5000;
+    bool fastPlacement = false;
+    std::string recordPath;
+    std::string datasetDirectory;
+    uint64_t shardMb = 64;
+    bool sprt = false;
+    double delta = 0.5;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+// Running sums for a mean and its confidence interval. Games played on the
+// same pooled layout are correlated, so with clusters set each layout counts
+// as one cluster and the interval uses the cluster-robust variance; when no
+// layout is used twice that is the usual one.
+struct Accumulator {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+    std::vector<uint64_t> clusterCounts; // Empty: every value stands alone
+    std::vector<double> clusterSums;
+
+    void SetClusterCount(size_t clusters) {
+        clusterCounts.assign(clusters, 0);
+        clusterSums.assign(clusters, 0.0);
+    }
+    void Add(double value, size_t cluster = 0) {
+        count++;
+        sum += value;
+        sumSquares += value * value;
+        if (!clusterCounts.empty()) {
+            clusterCounts[cluster]++;
+            clusterSums[cluster] += value;
+        }
+    }
+    void Merge(const Accumulator& other) {
+        count += other.count;
+        sum += other.sum;
+        sumSquares += other.sumSquares;
+        for (size_t cluster = 0; cluster < clusterCounts.size() && cluster < other.clusterCounts.size(); ++cluster) {
+            clusterCounts[cluster] += other.clusterCounts[cluster];
+            clusterSums[cluster] += other.clusterSums[cluster];
+        }
+    }
+    double Mean() const { return count ? sum / count : 0.0; }
+    // Estimated variance of the mean
+    double MeanVariance() const {
+        if (count < 2) return 0.0;
+        if (clusterCounts.empty()) {
+            return std::max(0.0, (sumSquares - sum * sum / count) / (count - 1)) / count;
+        }
+        double mean = Mean();
+        double squares = 0.0;
+        uint64_t used = 0;
+        for (size_t cluster = 0; cluster < clusterCounts.size(); ++cluster) {
+            if (clusterCounts[cluster] == 0) continue;
+            double deviation = clusterSums[cluster] - clusterCounts[cluster] * mean;
+            squares += deviation * deviation;
+            used++;
+        }
+        if (used < 2) return 0.0;
+        return squares * used / (used - 1) / ((double)count * count);
+    }
+    // Half-width of the 95% confidence interval of the mean
+    double HalfWidth95() const { return 1.96 * std::sqrt(MeanVariance()); }
+};
+
+// Everything one worker touches while playing; nothing here is shared
+struct alignas(64) Worker {
+    Accumulator shotsToWin[2]; // Indexed by Side: A plays Player, B plays AI
+    Accumulator winsA;         // 1 per game A won, else 0
+    uint64_t wins[2] = {0, 0};
+};
+
+// One paired comparison game, streamed from a worker to the main thread
+struct PairedResult {
+    uint32_t game;
+    uint16_t shotsA;
+    uint16_t shotsB;
+};
+
+uint64_t SplitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Ship sizes of the game fleet
+std::vector<int> GetFleetSizes() {
+    ShipManager ships;
+    std::vector<int> sizes;
+    for (const Ship& ship : ships.GetShips()) {
+        sizes.push_back(ship.size);
+    }
+    return sizes;
+}
+
+// Uniformly drawn layouts of the fleet, shared by every worker. An exact draw
+// costs ~3 ms, a hundred games' worth of shots, so both fleets of game g
+// come from entry g % LIMIT, each under its own pick of the board's eight
+// symmetries, which map a uniform layout to a uniform layout. Entry j depends only on the seed and j, so a
+// game doesn't depend on how many are played or on which thread.
+class LayoutPool {
+public:
+    static constexpr uint64_t LIMIT = 1024;
+
+    // Draws the entries the first gameCount games use, spread over threads
+    void Fill(std::span<const int> shipSizes, uint64_t gameCount, uint64_t seed, int threadCount) {
+        fleet.assign(shipSizes.begin(), shipSizes.end());
+        layouts.resize(std::min(gameCount, LIMIT) * fleet.size());
+        std::vector<std::thread> threads;
+        for (int i = 0; i < threadCount; ++i) {
+            threads.emplace_back([&, i] {
+                UniformFleetSampler sampler;
+                for (size_t entry = i; entry < GetSize(); entry += threadCount) {
+                    uint64_t entryState = seed ^ (entry * 0x9FB21C651E98DF25ull);
+                    std::mt19937 rng((uint32_t)SplitMix64(entryState));
+                    sampler.Sample(fleet, rng, std::span<ShipPlacement>(&layouts[entry * fleet.size()], fleet.size()));
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    size_t GetSize() const { return fleet.empty() ? 0 : layouts.size() / fleet.size(); }
+    // Entry the fleets of a game come from; 0 while the pool is empty
+    size_t GetEntry(uint64_t game) const { return GetSize() ? game % GetSize() : 0; }
+
+    // A fleet for the game, under a symmetry picked from seedState
+    void Get(uint64_t game, uint64_t& seedState, std::span<ShipPlacement> placements) const {
+        const ShipPlacement* entry = &layouts[GetEntry(game) * fleet.size()];
+        int symmetry = (int)(SplitMix64(seedState) & 7);
+        for (size_t i = 0; i < fleet.size(); ++i) {
+            placements[i] = Transform(entry[i], symmetry);
+        }
+    }
+
+private:
+    std::vector<int> fleet;
+    std::vector<ShipPlacement> layouts; // GetSize() layouts of fleet.size() ships
+
+    // Bit 0 mirrors x, bit 1 mirrors y, bit 2 swaps the axes
+    static ShipPlacement Transform(ShipPlacement ship, int symmetry) {
+        int spanX = ship.horizontal ? ship.size : 1;
+        int spanY = ship.horizontal ? 1 : ship.size;
+        if (symmetry & 1) ship.x = GRID_SIZE - ship.x - spanX;
+        if (symmetry & 2) ship.y = GRID_SIZE - ship.y - spanY;
+        if (symmetry & 4) {
+            std::swap(ship.x, ship.y);
+            ship.horizontal = !ship.horizontal;
+        }
+        return ship;
+    }
+};
+
+bool ParseStrategy(const char* name, TargetingStrategy& strategy) {
+    if (std::strcmp(name, "random") == 0) strategy = TargetingStrategy::RandomAdjacent;
+    else if (std::strcmp(name, "density") == 0) strategy = TargetingStrategy::ProbabilityDensity;
+    else if (std::strcmp(name, "hard") == 0) strategy = TargetingStrategy::MonteCarlo;
+    else return false;
+    return true;
+}
+
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--fast-placement") == 0) {
+            options.fastPlacement = true;
+            continue;
+        }
+        if (std::strcmp(arg, "--sprt") == 0) {
+            options.sprt = true;
+            continue;
+        }
+        if (!value) return false;
+        if (std::strcmp(arg, "--games") == 0) options.games = (uint32_t)std::strtoul(value, nullptr, 10);
+        else if (std::strcmp(arg, "--threads") == 0) options.threads = std::atoi(value);
+        else if (std::strcmp(arg, "--seed") == 0) options.seed = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(arg, "--record") == 0) options.recordPath = value;
+        else if (std::strcmp(arg, "--dataset") == 0) options.datasetDirectory = value;
+        else if (std::strcmp(arg, "--shard-mb") == 0) options.shardMb = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(arg, "--budget-us") == 0) options.budgetUs = std::atoi(value);
+        else if (std::strcmp(arg, "--delta") == 0) options.delta = std::atof(value);
+        else if (std::strcmp(arg, "--alpha") == 0) options.alpha = std::atof(value);
+        else if (std::strcmp(arg, "--beta") == 0) options.beta = std::atof(value);
+        else if (std::strcmp(arg, "--a") == 0) { if (!ParseStrategy(value, options.strategyA)) return false; }
+        else if (std::strcmp(arg, "--b") == 0) { if (!ParseStrategy(value, options.strategyB)) return false; }
+        else return false;
+        i++;
+    }
+    return options.games > 0 && options.delta > 0.0 && options.alpha > 0.0 && options.alpha < 1.0 &&
+           options.beta > 0.0 && options.beta < 1.0;
+}
+
+// Plays one game between two AIs
+class GameRunner {
+public:
+    // dataset may be null, and so may layouts with --fast-placement
+    GameRunner(const Options& options, const LayoutPool* layouts, DatasetWriter* dataset)
+        : options(options), layouts(layouts), dataset(dataset) {
+        TargetingStrategy strategies[2] = {options.strategyA, options.strategyB};
+        for (int side = 0; side < 2; ++side) {
+            players[side].SetVerbose(false);
+            players[side].SetTargetingStrategy(strategies[side]);
+            players[side].SetMonteCarloTimeBudget(std::chrono::microseconds(options.budgetUs));
+            players[side].SetMonteCarloThreadCount(1); // The tournament already uses every core
+        }
+        fleet = GetFleetSizes();
+    }
+
+    void Play(uint64_t gameIndex, Worker& worker) {
+        uint64_t seedState = options.seed ^ (gameIndex * 0xD1B54A32D192ED03ull);
+        uint64_t gameSeed = seedState;
+        match.Reset();
+        for (int side = 0; side < 2; ++side) {
+            AIPlayer& player = players[side];
+            player.SetSeed(SplitMix64(seedState));
+            player.Reset();
+            PlaceFleet((Side)side, gameIndex, seedState);
+        }
+        Side firstToMove = gameIndex % 2 == 0 ? Side::Player : Side::AI;
+        match.StartBattle(firstToMove);
+        bool recording = !options.recordPath.empty();
+        if (recording) {
+            recorder.BeginGame(gameSeed, firstToMove, match);
+        }
+
+        BitBoard sunkCells[2]; // Indexed by the side shot at
+        while (!match.IsOver()) {
+            Side shooter = match.GetSideToMove();
+            AIPlayer& player = players[(int)shooter];
+            const Grid& target = match.GetGrid(OpposingSide(shooter));
+            if (dataset) {
+                AddSample(gameIndex, shooter, target, sunkCells[(int)OpposingSide(shooter)]);
+            }
+            GridPosition shot = player.GetTarget(target);
+            ShotOutcome outcome;
+            if (!match.Fire(shot.x, shot.y, outcome)) {
+                std::cerr << "Game " << gameIndex << ": illegal shot, game abandoned" << std::endl;
+                if (recording) {
+                    recorder.EndGame(shooter, true);
+                }
+                samples.clear();
+                return;
+            }
+            if (recording) {
+                recorder.RecordShot(shooter, shot.x, shot.y, outcome);
+            }
+            if (dataset) {
+                DatasetRecord& sample = samples.back();
+                sample.action = (uint8_t)BitBoard::CellIndex(shot.x, shot.y);
+                sample.result = (outcome.result != ShotResult::Miss ? DatasetFormat::SHOT_HIT : 0) |
+                                (outcome.result == ShotResult::Sunk ? DatasetFormat::SHOT_SUNK : 0);
+            }
+            if (outcome.result != ShotResult::Miss) {
+                player.SetLastHit(shot);
+            }
+            if (outcome.result == ShotResult::Sunk) {
+                player.NotifyShipSunk(target.GetShipCells(outcome.shipId));
+                sunkCells[(int)OpposingSide(shooter)] |= target.GetShipCells(outcome.shipId);
+            }
+        }
+        if (dataset) {
+            for (DatasetRecord& sample : samples) {
+                Side shooter = (Side)sample.shooter;
+                sample.shooterWon = shooter == match.GetWinner();
+                sample.shotsToFinish = (uint16_t)(match.GetShotCount(shooter) - sample.shot);
+            }
+            dataset->Submit(samples);
+            samples.clear();
+        }
+
+        if (recording) {
+            recorder.EndGame(match.GetWinner());
+        }
+        int winner = (int)match.GetWinner();
+        size_t cluster = layouts->GetEntry(gameIndex);
+        worker.wins[winner]++;
+        worker.winsA.Add(winner == 0 ? 1.0 : 0.0, cluster);
+        worker.shotsToWin[winner].Add(match.GetShotCount(match.GetWinner()), cluster);
+    }
+
+    // Both strategies shoot alone at the same fleet with the same seed, so
+    // the difference reflects the strategies rather than the luck of the draw
+    PairedResult PlayPaired(uint64_t gameIndex) {
+        uint64_t seedState = options.seed ^ (gameIndex * 0xD1B54A32D192ED03ull);
+        uint64_t fleetSeed = SplitMix64(seedState);
+        uint64_t shooterSeed = SplitMix64(seedState);
+
+        match.Reset();
+        PlaceFleet(Side::AI, gameIndex, fleetSeed);
+        const Grid& hidden = match.GetGrid(Side::AI);
+
+        PairedResult result{(uint32_t)gameIndex, 0, 0};
+        result.shotsA = (uint16_t)ShootOut(players[0], hidden, shooterSeed);
+        result.shotsB = (uint16_t)ShootOut(players[1], hidden, shooterSeed);
+        return result;
+    }
+
+    // Games recorded by Play since the last call to ClearRecords
+    const std::vector<uint8_t>& GetRecords() const { return recorder.GetBytes(); }
+    void ClearRecords() { recorder.Clear(); }
+
+private:
+    const Options& options;
+    const LayoutPool* layouts;
+    AIPlayer players[2];
+    Match match;
+    std::vector<int> fleet;
+    GameRecordEncoder recorder;
+    DatasetWriter* dataset;
+    std::vector<DatasetRecord> samples; // Of the game in progress
+
+    void PlaceFleet(Side side, uint64_t gameIndex, uint64_t& seedState) {
+        if (options.fastPlacement) {
+            std::mt19937 placementRng((uint32_t)SplitMix64(seedState));
+            match.PlaceFleetRandomly(side, fleet, placementRng);
+            return;
+        }
+        std::array<ShipPlacement, MAX_FLEET_SIZE> placements;
+        std::span<ShipPlacement> layout(placements.data(), fleet.size());
+        layouts->Get(gameIndex, seedState, layout);
+        match.PlaceFleet(side, layout);
+    }
+
+    void AddSample(uint64_t gameIndex, Side shooter, const Grid& target, const BitBoard& sunk) {
+        DatasetRecord& sample = samples.emplace_back();
+        sample = {};
+        sample.hits[0] = target.GetHitMask().lo;
+        sample.hits[1] = target.GetHitMask().hi;
+        sample.misses[0] = target.GetMissMask().lo;
+        sample.misses[1] = target.GetMissMask().hi;
+        sample.sunk[0] = sunk.lo;
+        sample.sunk[1] = sunk.hi;
+        sample.game = (uint32_t)gameIndex;
+        sample.shot = (uint16_t)match.GetShotCount(shooter);
+        sample.shooter = (uint8_t)shooter;
+    }
+
+    // Shots the player needs to sink a copy of the fleet
+    static int ShootOut(AIPlayer& player, Grid target, uint64_t seed) {
+        player.SetSeed(seed);
+        player.Reset();
+        int shots = 0;
+        while (target.CountRemainingShips() > 0 && shots < GRID_SIZE * GRID_SIZE) {
+            GridPosition shot = player.GetTarget(target);
+            ShotResult result = target.ReceiveShot(shot.x, shot.y);
+            shots++; // A repeated shot is wasted, not free
+            if (result == ShotResult::Hit || result == ShotResult::Sunk) {
+                player.SetLastHit(shot);
+            }
+            if (result == ShotResult::Sunk) {
+                player.NotifyShipSunk(target.GetShipCells(target.GetShipId(shot.x, shot.y)));
+            }
+        }
+        return shots;
+    }
+};
+
+// Draws the layout pool unless --fast-placement is set, and says what the
+// placement costs and how often layouts repeat
+void PreparePlacement(const Options& options, uint64_t gameCount, int threadCount, LayoutPool& layouts) {
+    if (options.fastPlacement) {
+        std::cout << "Placement: backtracking generator (fast, not uniform)" << std::endl;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    layouts.Fill(GetFleetSizes(), gameCount, options.seed, threadCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Placement: " << layouts.GetSize() << " uniform layouts drawn in " << seconds << " s";
+    if (layouts.GetSize() < gameCount) {
+        std::cout << ", each reused under the board's symmetries for up to "
+                  << (gameCount + layouts.GetSize() - 1) / layouts.GetSize()
+                  << " games; intervals count the games on one layout as one cluster";
+    }
+    std::cout << std::endl;
+}
+
+// Sequential probability ratio test on the per-game differences d = shotsB -
+// shotsA, normal with the sample variance: H0 says mean 0, H1 says mean delta.
+// Games on a reused layout are clustered as in Accumulator, and the variance
+// is the per-game one that matches the clustered variance of the mean.
+class Sprt {
+public:
+    enum class Verdict { Continue, AcceptH0, AcceptH1 };
+
+    Sprt(double delta, double alpha, double beta, size_t clusters)
+        : delta(delta), lowerBound(std::log(beta / (1.0 - alpha))), upperBound(std::log((1.0 - beta) / alpha)) {
+        differences.SetClusterCount(clusters);
+    }
+
+    Verdict Add(double difference, size_t cluster) {
+        differences.Add(difference, cluster);
+        if (differences.count < MIN_GAMES) return Verdict::Continue;
+        double llr = GetLlr();
+        if (llr >= upperBound) return Verdict::AcceptH1;
+        if (llr <= lowerBound) return Verdict::AcceptH0;
+        return Verdict::Continue;
+    }
+
+    double GetLlr() const {
+        uint64_t n = differences.count;
+        if (n < 2) return 0.0;
+        double variance = differences.MeanVariance() * n;
+        if (variance <= 0.0) variance = 1e-9; // Identical results so far
+        return delta / variance * (differences.sum - n * delta / 2.0);
+    }
+
+    double GetLowerBound() const { return lowerBound; }
+    double GetUpperBound() const { return upperBound; }
+    const Accumulator& GetDifferences() const { return differences; }
+
+private:
+    // The variance estimate is too noisy to stop on before this
+    static constexpr uint64_t MIN_GAMES = 32;
+
+    double delta;
+    double lowerBound;
+    double upperBound;
+    Accumulator differences;
+};
+
+// Plays paired games until the SPRT decides or the game cap is hit. Workers
+// stream results through their own ring; the main thread feeds them to the
+// test in game order, so where the run stops doesn't depend on scheduling.
+// Chunks are handed out in game order and no worker starts one more than a
+// window ahead of the test, so results wait in a window of a few chunks per
+// thread rather than in arrays as long as the cap.
+int RunSprt(const Options& options, int threadCount) {
+    constexpr uint32_t CHUNK = 4;
+    using ResultRing = SpscRing<PairedResult, 1024>;
+    std::vector<std::unique_ptr<ResultRing>> rings;
+    for (int i = 0; i < threadCount; ++i) {
+        rings.push_back(std::make_unique<ResultRing>());
+    }
+    LayoutPool layouts;
+    PreparePlacement(options, options.games, threadCount, layouts);
+    const uint32_t windowSize = (uint32_t)threadCount * CHUNK * 4;
+    std::atomic<uint64_t> nextChunk{0};
+    std::atomic<uint32_t> tested{0}; // Games fed to the test so far
+    std::atomic<bool> stopping{false};
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&, i] {
+            GameRunner runner(options, &layouts, nullptr);
+            while (!stopping.load(std::memory_order_relaxed)) {
+                uint64_t begin = nextChunk.fetch_add(CHUNK, std::memory_order_relaxed);
+                if (begin >= options.games) return;
+                uint64_t end = std::min<uint64_t>(begin + CHUNK, options.games);
+                // The chunk holding the next game to test never waits here
+                while (end > (uint64_t)tested.load(std::memory_order_acquire) + windowSize) {
+                    if (stopping.load(std::memory_order_relaxed)) return;
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                for (uint64_t game = begin; game < end && !stopping.load(std::memory_order_relaxed); ++game) {
+                    PairedResult result = runner.PlayPaired(game);
+                    while (!rings[i]->TryPush(result)) {
+                        if (stopping.load(std::memory_order_relaxed)) return;
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        });
+    }
+
+    Sprt sprt(options.delta, options.alpha, options.beta, layouts.GetSize());
+    Sprt::Verdict verdict = Sprt::Verdict::Continue;
+    // Slot game % windowSize; a slot holds game g once its result for g arrived
+    std::vector<PairedResult> window(windowSize, PairedResult{UINT32_MAX, 0, 0});
+    uint32_t nextGame = 0;
+    while (verdict == Sprt::Verdict::Continue && nextGame < options.games) {
+        bool progressed = false;
+        PairedResult result;
+        for (auto& ring : rings) {
+            while (ring->TryPop(result)) {
+                window[result.game % windowSize] = result;
+                progressed = true;
+            }
+        }
+        while (verdict == Sprt::Verdict::Continue && nextGame < options.games &&
+               window[nextGame % windowSize].game == nextGame) {
+            const PairedResult& next = window[nextGame++ % windowSize];
+            verdict = sprt.Add((double)next.shotsB - (double)next.shotsA, layouts.GetEntry(next.game));
+        }
+        tested.store(nextGame, std::memory_order_release);
+        if (!progressed) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    stopping.store(true, std::memory_order_relaxed);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const char* nameA = GetTargetingStrategyName(options.strategyA);
+    const char* nameB = GetTargetingStrategyName(options.strategyB);
+    const Accumulator& differences = sprt.GetDifferences();
+    std::cout << "Games used: " << differences.count << " of " << options.games << " (" << differences.count / seconds
+              << " pairs/sec)" << std::endl;
+    std::cout << "Mean shots " << nameB << " - " << nameA << ": " << differences.Mean() << " +- "
+              << differences.HalfWidth95() << std::endl;
+    std::cout << "LLR: " << sprt.GetLlr() << " (bounds " << sprt.GetLowerBound() << ", " << sprt.GetUpperBound()
+              << ")" << std::endl;
+    switch (verdict) {
+        case Sprt::Verdict::AcceptH1:
+            std::cout << "H1 accepted: " << nameA << " (A) is better by at least " << options.delta << " shots"
+                      << std::endl;
+            return 0;
+        case Sprt::Verdict::AcceptH0:
+            std::cout << "H0 accepted: " << nameA << " (A) is not better by " << options.delta << " shots" << std::endl;
+            return 0;
+        default:
+            std::cout << "Inconclusive: game cap reached" << std::endl;
+            return 1;
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        std::cerr << "Usage: battleship_tournament [--games N] [--threads N] [--seed N] "
+                     "[--a random|density|hard] [--b random|density|hard] [--budget-us N] [--fast-placement] "
+                     "[--record PATH] [--dataset DIR [--shard-mb N]] [--sprt [--delta SHOTS] [--alpha P] [--beta P]]"
+                  << std::endl;
+        return 2;
+    }
+    int threadCount = options.threads > 0 ? options.threads : std::max(1, (int)std::thread::hardware_concurrency());
+    const char* nameA = GetTargetingStrategyName(options.strategyA);
+    const char* nameB = GetTargetingStrategyName(options.strategyB);
+    if (options.sprt) {
+        std::cout << "SPRT: " << nameA << " (A) vs " << nameB << " (B), delta " << options.delta << " shots, alpha "
+                  << options.alpha << ", beta " << options.beta << ", at most " << options.games << " games on "
+                  << threadCount << " threads, seed " << options.seed << std::endl;
+        return RunSprt(options, threadCount);
+    }
+    std::cout << "Tournament: " << nameA << " (A) vs " << nameB << " (B), " << options.games << " games on "
+              << threadCount << " threads, seed " << options.seed << std::endl;
+
+    GameRecordWriter recordWriter;
+    std::mutex recordMutex;
+    if (!options.recordPath.empty() && !recordWriter.Open(options.recordPath)) {
+        std::cerr << "Cannot create " << options.recordPath << std::endl;
+        return 2;
+    }
+    DatasetWriter dataset;
+    if (!options.datasetDirectory.empty() && !dataset.Open(options.datasetDirectory, options.shardMb << 20)) {
+        return 2;
+    }
+
+    LayoutPool layouts;
+    PreparePlacement(options, options.games, threadCount, layouts);
+    std::vector<Worker> workers(threadCount);
+    for (Worker& worker : workers) {
+        worker.winsA.SetClusterCount(layouts.GetSize());
+        for (Accumulator& shots : worker.shotsToWin) {
+            shots.SetClusterCount(layouts.GetSize());
+        }
+    }
+    WorkStealingRanges scheduler(options.games, threadCount, 16);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&, i] {
+            GameRunner runner(options, &layouts, options.datasetDirectory.empty() ? nullptr : &dataset);
+            uint32_t begin, end;
+            while (scheduler.Next(i, begin, end)) {
+                for (uint32_t game = begin; game < end; ++game) {
+                    runner.Play(game, workers[i]);
+                }
+                // Games land in the file a range at a time, not in index order
+                if (!runner.GetRecords().empty()) {
+                    std::lock_guard<std::mutex> lock(recordMutex);
+                    recordWriter.AppendGames(runner.GetRecords());
+                    runner.ClearRecords();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (recordWriter.IsOpen()) {
+        recordWriter.Close();
+        std::cout << "Recorded " << recordWriter.GetBytesWritten() << " bytes to " << options.recordPath << std::endl;
+    }
+    if (!options.datasetDirectory.empty()) {
+        if (!dataset.Close()) {
+            std::cerr << "Dataset in " << options.datasetDirectory << " is incomplete" << std::endl;
+            return 1;
+        }
+        std::cout << "Dataset: " << dataset.GetRecordCount() << " records in " << dataset.GetShardCount()
+                  << " shards in " << options.datasetDirectory << std::endl;
+    }
+
+    Worker total;
+    total.winsA.SetClusterCount(layouts.GetSize());
+    for (Accumulator& shots : total.shotsToWin) {
+        shots.SetClusterCount(layouts.GetSize());
+    }
+    for (const Worker& worker : workers) {
+        total.winsA.Merge(worker.winsA);
+        for (int side = 0; side < 2; ++side) {
+            total.wins[side] += worker.wins[side];
+            total.shotsToWin[side].Merge(worker.shotsToWin[side]);
+        }
+    }
+    uint64_t played = total.wins[0] + total.wins[1];
+    double winRate = total.winsA.Mean();
+    double winRateHalfWidth = total.winsA.HalfWidth95();
+
+    std::cout << "Games/sec: " << played / seconds << " (" << played << " games in " << seconds << " s)" << std::endl;
+    std::cout << "Win rate " << nameA << " (A): " << 100.0 * winRate << "% +- " << 100.0 * winRateHalfWidth
+              << "%" << std::endl;
+    const char* names[2] = {nameA, nameB};
+    for (int side = 0; side < 2; ++side) {
+        const Accumulator& shots = total.shotsToWin[side];
+        std::cout << "Mean shots-to-win " << names[side] << " (" << (side == 0 ? "A" : "B") << "): "
+                  << shots.Mean() << " +- " << shots.HalfWidth95() << " over " << shots.count << " wins" << std::endl;
+    }
+    return played == options.games ? 0 : 1;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Hands out the indices [0, total) to a fixed set of workers. Every worker
+// owns a contiguous range and takes chunks off its front; once its range is
+// empty it steals the back half of another worker's range. Ranges are packed
+// into one atomic word each, so the only shared writes are the occasional
+// steals.
+class WorkStealingRanges {
+public:
+    WorkStealingRanges(uint32_t total, int workerCount, uint32_t chunkSize)
+        : slots(std::make_unique<Slot[]>(workerCount)), workers(workerCount), chunk(std::max(1u, chunkSize)) {
+        for (int i = 0; i < workerCount; ++i) {
+            uint32_t begin = (uint32_t)((uint64_t)total * i / workerCount);
+            uint32_t end = (uint32_t)((uint64_t)total * (i + 1) / workerCount);
+            slots[i].range.store(Pack(begin, end), std::memory_order_relaxed);
+        }
+    }
+
+    // Next chunk [begin, end) for the worker; false once all work is handed out
+    bool Next(int worker, uint32_t& begin, uint32_t& end) {
+        std::atomic<uint64_t>& own = slots[worker].range;
+        while (true) {
+            uint64_t range = own.load(std::memory_order_acquire);
+            uint32_t first = Begin(range);
+            uint32_t last = End(range);
+            if (first < last) {
+                uint32_t next = std::min(first + chunk, last);
+                if (own.compare_exchange_weak(range, Pack(next, last), std::memory_order_acq_rel)) {
+                    begin = first;
+                    end = next;
+                    return true;
+                }
+                continue;
+            }
+            if (!Steal(worker)) {
+                return false;
+            }
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> range{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    int workers;
+    uint32_t chunk;
+
+    static constexpr uint64_t Pack(uint32_t begin, uint32_t end) { return (uint64_t)end << 32 | begin; }
+    static constexpr uint32_t Begin(uint64_t range) { return (uint32_t)range; }
+    static constexpr uint32_t End(uint64_t range) { return (uint32_t)(range >> 32); }
+
+    // Moves the back half of some other worker's range into the thief's own
+    // (empty) range. Only the owner refills an empty range, so a plain store
+    // is enough once the victim has given the work up.
+    bool Steal(int thief) {
+        for (int offset = 1; offset < workers; ++offset) {
+            std::atomic<uint64_t>& victim = slots[(thief + offset) % workers].range;
+            uint64_t range = victim.load(std::memory_order_acquire);
+            while (Begin(range) < End(range)) {
+                uint32_t first = Begin(range);
+                uint32_t last = End(range);
+                uint32_t middle = last - first > chunk ? first + (last - first) / 2 : first;
+                if (victim.compare_exchange_weak(range, Pack(first, middle), std::memory_order_acq_rel)) {
+                    slots[thief].range.store(Pack(middle, last), std::memory_order_release);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};